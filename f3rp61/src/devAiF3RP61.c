@@ -35,6 +35,7 @@
 #include <aiRecord.h>
 
 #include <drvF3RP61.h>
+#include <devF3RP61conv.h>
 
 // Create the dset for devAiF3RP61
 static long init_record();
@@ -61,11 +62,13 @@ struct {
 epicsExportAddress(dset, devAiF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     union {
         M3IO_ACCESS_COM acom;
         M3IO_ACCESS_REG drly;
     } u;
+    F3RP61_SCAN_CACHE_REF cache;
     char device;
     char option;
 } F3RP61_AI_DPVT;
@@ -116,6 +119,7 @@ static long init_record(aiRecord *precord)
     }
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':'); // check if SCAN is interrupt based (example: @U0,S3,Y1:U0,S4,X1)
     if (pint) {
         *pint++ = '\0';
@@ -125,7 +129,7 @@ static long init_record(aiRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start, &intr) < 0) {
             errlogPrintf("devAiF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -150,6 +154,7 @@ static long init_record(aiRecord *precord)
 
     // Allocate private data storage area
     F3RP61_AI_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_AI_DPVT), "calloc failed");
+    dpvt->intr = intr;
     dpvt->device = device;
     dpvt->option = option;
 
@@ -195,6 +200,14 @@ static long init_record(aiRecord *precord)
             pdrly->count = count;
         }
 
+        // Periodically scanned records share a snapshot of registers on the slot
+        if (f3rp61_register_scan_cache((dbCommon *) precord, &dpvt->cache, device, unitno, slotno, start, count,
+                                       option == 'L' || option == 'F' || option == 'D') < 0) {
+            errlogPrintf("devAiF3RP61: can't register scan cache for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+
     } else {
         errlogPrintf("devAiF3RP61: unsupported device \'%c\' for %s\n", device, precord->name);
         precord->pact = 1;
@@ -217,6 +230,9 @@ static long read_ai(aiRecord *precord)
     const char device = dpvt->device;
     const char option = dpvt->option;
 
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
     // Buffers for data read
     uint16_t wdata[4] = {0};
     ulong    ldata[2] = {0};
@@ -225,13 +241,13 @@ static long read_ai(aiRecord *precord)
     if (0) {                    // dummy
 
     } else if (device == 'R') { // Shared registers
-        if (readM3ComRegister(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3ComRegister(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devAiF3RP61: readM3ComRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'W') { // Link registers
-        if (readM3LinkRegister(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3LinkRegister(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devAiF3RP61: readM3LinkRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -239,19 +255,19 @@ static long read_ai(aiRecord *precord)
     } else if (device == 'r') { // Shared memory
 #if defined(__powerpc__)
         pacom->pdata = wdata;
-        if (ioctl(f3rp61_fd, M3IO_READ_COM, pacom) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_COM, pacom) < 0) {
             errlogPrintf("devAiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #else
-        if (readM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devAiF3RP61: readM3CpuMemory failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #endif
 
     } else if (device == 'X') { // Input relays on I/O modules
-        if (ioctl(f3rp61_fd, M3IO_READ_INRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_INRELAY, pdrly) < 0) {
             errlogPrintf("devAiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -266,7 +282,7 @@ static long read_ai(aiRecord *precord)
         }
 
     } else if (device == 'Y') { // Output relays on I/O modules
-        if (ioctl(f3rp61_fd, M3IO_READ_OUTRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_OUTRELAY, pdrly) < 0) {
             errlogPrintf("devAiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -292,16 +308,26 @@ static long read_ai(aiRecord *precord)
         }
 #endif
 
+    } else if (dpvt->cache.pcache) { // I/O registers on special modules, through scan cache
+        const int count = (option == 'D') ? 4 : (option == 'L' || option == 'F') ? 2 : 1;
+        if (f3rp61_read_scan_cache((dbCommon *) precord, &dpvt->cache, pdrly->start, count, wdata) < 0) {
+            errlogPrintf("devAiF3RP61: f3rp61_read_scan_cache failed [%d] for %s\n", errno, precord->name);
+            return -1;
+        }
+        // Lower word comes first as is the case with M3IO_READ_REG_L
+        ldata[0] = devF3RP61words2long(&wdata[0]);
+        ldata[1] = devF3RP61words2long(&wdata[2]);
+
     } else {//(device == 'A')   // I/O registers on special modules
         if (option == 'L' || option == 'F' || option == 'D') {
             pdrly->u.pldata = ldata;
-            if (ioctl(f3rp61_fd, M3IO_READ_REG_L, pdrly) < 0) {
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG_L, pdrly) < 0) {
                 errlogPrintf("devAiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
                 return -1;
             }
         } else {
             pdrly->u.pwdata = wdata;
-            if (ioctl(f3rp61_fd, M3IO_READ_REG, pdrly) < 0) {
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG, pdrly) < 0) {
                 errlogPrintf("devAiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
                 return -1;
             }
@@ -313,29 +339,14 @@ static long read_ai(aiRecord *precord)
 
     // fill VAL field
     if (option == 'D') {
-        double val;
-        if (device == 'A') {
-            uint64_t lval = (((uint64_t)ldata[1])<<32) | (uint64_t)ldata[0];
-            memcpy(&val, &lval, sizeof(double));
-        } else {
-            uint64_t lval = (((uint64_t)wdata[3])<<48) | (((uint64_t)wdata[2])<<32) | ((uint64_t)wdata[1]<<16) | (uint64_t)wdata[0];
-
-            memcpy(&val, &lval, sizeof(double));
-        }
+        const double val = (device == 'A') ? devF3RP61longs2double(ldata) : devF3RP61words2double(wdata);
         // todo : consider ASLO and AOFF field
         // todo : consider SMOO field
         precord->val = val;
         precord->udf = isnan(precord->val);
         return 2; // no conversion
     } else if (option == 'F') {
-        float val;
-        if (device == 'A') {
-            uint32_t lval = ldata[0];
-            memcpy(&val, &lval, sizeof(float));
-        } else {
-            uint32_t lval = (wdata[1]<<16) | wdata[0];
-            memcpy(&val, &lval, sizeof(float));
-        }
+        const float val = (device == 'A') ? devF3RP61longs2float(ldata) : devF3RP61words2float(wdata);
         // todo : consider ASLO and AOFF field
         // todo : consider SMOO field
         precord->val = val;
@@ -345,7 +356,7 @@ static long read_ai(aiRecord *precord)
         if (device == 'A') {
             precord->rval = ldata[0];
         } else {
-            precord->rval = wdata[1]<<16 | wdata[0];
+            precord->rval = devF3RP61words2long(wdata);
         }
     } else if (option == 'U') {
         precord->rval = (uint16_t)wdata[0];
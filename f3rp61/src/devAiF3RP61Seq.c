@@ -35,6 +35,7 @@
 #include <aiRecord.h>
 
 #include <drvF3RP61Seq.h>
+#include <devF3RP61conv.h>
 
 // Create the dset for devAiF3RP61Seq
 static long init_record();
@@ -83,6 +84,9 @@ static long init_record(aiRecord *precord)
     strncpy(buf, plink->value.instio.string, size);
     buf[size - 1] = '\0';
 
+    // Parse cached mode option, read from the image polled in bulk
+    const int cached = f3rp61Seq_parseCachedOption(buf);
+
     // Parse option
     char *popt = strchr(buf, '&');
     if (popt) {
@@ -128,7 +132,7 @@ static long init_record(aiRecord *precord)
     }
 
     // Read the slot number of CPU module
-    if (ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
         errlogPrintf("devAiF3RP61Seq: ioctl failed [%d] for %s\n", errno, precord->name);
         precord->pact = 1;
         return -1;
@@ -138,30 +142,28 @@ static long init_record(aiRecord *precord)
     F3RP61_SEQ_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_SEQ_DPVT), "calloc failed");
     dpvt->option = option;
 
-    // Compose data structure for I/O request to CPU module
-    MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-    pmcmdStruct->timeOut = 1;
-
-    MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-    pmcmdRequest->formatCode = 0xf1;
-    pmcmdRequest->responseOption = 1;
-    pmcmdRequest->srcSlot = srcSlot;
-    pmcmdRequest->destSlot = destSlot;
-    pmcmdRequest->mainCode = 0x26;
-    pmcmdRequest->subCode = 0x01;
-    pmcmdRequest->dataSize = 10;
-
-    M3_READ_SEQDEV *pM3ReadSeqdev = (M3_READ_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-    pM3ReadSeqdev->accessType = kWord;
+    // Describe the devices accessed by I/O request to CPU module
+    F3RP61_SEQ_ADDR *paddr = &dpvt->addr;
+    paddr->srcSlot = srcSlot;
+    paddr->destSlot = destSlot;
+    paddr->subCode = 0x01; // read
+    paddr->accessType = kWord;
     if (option == 'D') {
-        pM3ReadSeqdev->dataNum = 4;
+        paddr->dataNum = 4;
     } else if (option == 'F' || option == 'L') {
-        pM3ReadSeqdev->dataNum = 2;
+        paddr->dataNum = 2;
     } else {
-        pM3ReadSeqdev->dataNum = 1;
+        paddr->dataNum = 1;
+    }
+    paddr->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
+    paddr->topDevNo = top;
+
+    // Attach to the polled image in the cached mode
+    if (cached && f3rp61Seq_attachPoll(dpvt) < 0) {
+        errlogPrintf("devAiF3RP61Seq: no image polled by f3rp61SeqPoll covers %s\n", precord->name);
+        precord->pact = 1;
+        return -1;
     }
-    pM3ReadSeqdev->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
-    pM3ReadSeqdev->topDevNo = top;
 
     //
     callbackSetUser(precord, &dpvt->callback);
@@ -177,18 +179,21 @@ static long read_ai(aiRecord *precord)
 {
     F3RP61_SEQ_DPVT *dpvt = precord->dpvt;
 
-    if (precord->pact) { // Second call (PACT is TRUE)
+    // Read the polled image synchronously in the cached mode
+    if (dpvt->ppoll && f3rp61Seq_readPoll((dbCommon *) precord, dpvt) < 0) {
+        return -1;
+    }
+
+    if (precord->pact || dpvt->ppoll) { // Second call (PACT is TRUE), or cached mode
         if (dpvt->ret < 0) {
             errlogPrintf("devAiF3RP61Seq: read_ai failed for %s\n", precord->name);
             return -1;
         }
 
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_RESPONSE *pmcmdResponse = &pmcmdStruct->mcmdResponse;
-        uint16_t *wdata = pmcmdResponse->dataBuff.wData;
+        uint16_t *wdata = dpvt->wData;
 
-        if (pmcmdResponse->errorCode) {
-            errlogPrintf("devAiF3RP61Seq: errorCode 0x%04x returned for %s\n", pmcmdResponse->errorCode, precord->name);
+        if (dpvt->errorCode) {
+            errlogPrintf("devAiF3RP61Seq: errorCode 0x%04x returned for %s\n", dpvt->errorCode, precord->name);
             return -1;
         }
 
@@ -198,13 +203,7 @@ static long read_ai(aiRecord *precord)
         // fill VAL field
         const char option = dpvt->option;
         if (option == 'D') {
-            const uint64_t l0 = wdata[0];
-            const uint64_t l1 = wdata[1];
-            const uint64_t l2 = wdata[2];
-            const uint64_t l3 = wdata[3];
-            const uint64_t lval = (l3<<48) | (l2<<32) | (l1<<16) | l0;
-            double val;
-            memcpy(&val, &lval, sizeof(double));
+            const double val = devF3RP61words2double(wdata);
 
             // todo : consider ASLO and AOFF field
             // todo : consider SMOO field
@@ -213,11 +212,7 @@ static long read_ai(aiRecord *precord)
             return 2; // no conversion
 
         } else if (option == 'F') {
-            const uint32_t l0 = wdata[0];
-            const uint32_t l1 = wdata[1];
-            const uint32_t lval = (l1<<16) | l0;
-            float val;
-            memcpy(&val, &lval, sizeof(float));
+            const float val = devF3RP61words2float(wdata);
 
             // todo : consider ASLO and AOFF field
             // todo : consider SMOO field
@@ -226,9 +221,7 @@ static long read_ai(aiRecord *precord)
             return 2; // no conversion
 
         } else if (option == 'L') {
-            const uint32_t l0 = wdata[0];
-            const uint32_t l1 = wdata[1];
-            precord->rval = l1<<16 | l0;
+            precord->rval = devF3RP61words2long(wdata);
 
         } else if (option == 'U') {
             precord->rval = (uint16_t)wdata[0];
@@ -35,6 +35,7 @@
 #include <aoRecord.h>
 
 #include <drvF3RP61.h>
+#include <devF3RP61conv.h>
 
 // Create the dset for devAoF3RP61
 static long init_record();
@@ -61,11 +62,15 @@ struct {
 epicsExportAddress(dset, devAoF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     union {
         M3IO_ACCESS_COM acom;
         M3IO_ACCESS_REG drly;
     } u;
+    F3RP61_LAST_WRITE last;
+    F3RP61_STAGE *pstage; // NULL unless staged until committed
+    F3RP61_RAMP *pramp;   // NULL unless ramped by the driver
     char device;
     char option;
 } F3RP61_AO_DPVT;
@@ -93,6 +98,24 @@ static long init_record(aoRecord *precord)
     strncpy(buf, plink->value.instio.string, size);
     buf[size - 1] = '\0';
 
+    // Parse option to skip writing unchanged values, which may come along
+    // with another option
+    const int suppress = f3rp61_parse_suppress_option(buf);
+
+    // Parse option to stage the value until committed, which may come
+    // along with another option
+    const int staged = f3rp61_parse_staged_option(buf);
+
+    // Parse option to ramp to the value at a rate, which may come along
+    // with another option
+    double rate = 0.0;
+    const int ramped = f3rp61_parse_ramp_option(buf, &rate);
+    if (ramped < 0) {
+        errlogPrintf("devAoF3RP61: can't get ramp rate for %s\n", precord->name);
+        precord->pact = 1;
+        return -1;
+    }
+
     // Parse option
     char *popt = strchr(buf, '&');
     if (popt) {
@@ -116,6 +139,7 @@ static long init_record(aoRecord *precord)
     }
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':'); // check if SCAN is interrupt based (example: @U0,S3,Y1:U0,S4,X1)
     if (pint) {
         *pint++ = '\0';
@@ -124,7 +148,7 @@ static long init_record(aoRecord *precord)
             precord->pact = 1;
             return -1;
         }
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start, &intr) < 0) {
             errlogPrintf("devAoF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -147,8 +171,24 @@ static long init_record(aoRecord *precord)
         }
     }
 
+    // Only I/O registers are staged
+    if (staged && device != 'A') {
+        errlogPrintf("devAoF3RP61: option \'T\' is not supported for device \'%c\' of %s\n", device, precord->name);
+        precord->pact = 1;
+        return -1;
+    }
+
+    // Only I/O registers and shared registers are ramped, by themselves
+    if (ramped && ((device != 'A' && device != 'R') || staged || suppress)) {
+        errlogPrintf("devAoF3RP61: option \'R\' is not supported for device \'%c\' or with other options of %s\n", device, precord->name);
+        precord->pact = 1;
+        return -1;
+    }
+
     // Allocate private data storage area
     F3RP61_AO_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_AO_DPVT), "calloc failed");
+    dpvt->intr = intr;
+    dpvt->last.enabled = suppress;
     dpvt->device = device;
     dpvt->option = option;
 
@@ -194,14 +234,59 @@ static long init_record(aoRecord *precord)
             pdrly->count  = count;
         }
 
+        if (staged) {
+            if (f3rp61_register_stage((dbCommon *) precord, &dpvt->pstage, unitno, slotno, start, count) < 0) {
+                errlogPrintf("devAoF3RP61: can't register staged registers for %s\n", precord->name);
+                precord->pact = 1;
+                return -1;
+            }
+        }
+
     } else {
         errlogPrintf("devAoF3RP61: unsupported device \'%c\' for %s\n", device, precord->name);
         precord->pact = 1;
         return -1;
     }
 
+    if (ramped) {
+        if (f3rp61_register_ramp((dbCommon *) precord, &dpvt->pramp, device, unitno, slotno, start, option, rate) < 0) {
+            errlogPrintf("devAoF3RP61: can't register ramp for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+    }
+
     precord->dpvt = dpvt;
 
+    // Start from the value read back from the device at iocInit
+    uint16_t wdata[4] = {0};
+    if ((device == 'R' || device == 'Y' || device == 'A') &&
+        f3rp61_get_readback(device, unitno, slotno, start, count, wdata) == 0) {
+        f3rp61_set_last_write(&dpvt->last, wdata, count);
+        precord->udf = FALSE;
+        if (option == 'D') {
+            precord->val = devF3RP61words2double(wdata);
+        } else if (option == 'F') {
+            precord->val = devF3RP61words2float(wdata);
+        } else if (option == 'L') {
+            precord->rval = (int32_t) devF3RP61words2long(wdata);
+        } else if (option == 'U') {
+            precord->rval = wdata[0];
+        } else {
+            precord->rval = (int16_t) wdata[0];
+        }
+
+        if (option == 'D' || option == 'F') {
+            if (dpvt->pramp) {
+                f3rp61_set_ramp(dpvt->pramp, precord->val);
+            }
+            return 2; // don't convert
+        }
+        if (dpvt->pramp) {
+            f3rp61_set_ramp(dpvt->pramp, precord->rval);
+        }
+    }
+
     return 0;
 }
 
@@ -215,6 +300,22 @@ static long write_ao(aoRecord *precord)
     const char device = dpvt->device;
     const char option = dpvt->option;
 
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
+    // Hand the target to the ramp, which writes the values on the way
+    if (dpvt->pramp) {
+        if (option == 'D' || option == 'F') {
+            f3rp61_write_ramp(dpvt->pramp, precord->val);
+            precord->udf = isnan(precord->val);
+        } else {
+            f3rp61_write_ramp(dpvt->pramp, precord->rval);
+            precord->udf = FALSE;
+        }
+
+        return 0;
+    }
+
     // Compose data to write
     uint16_t wdata[4] = {0};
     uint16_t mask[4]  = {0xffff, 0xffff, 0xffff, 0xffff};
@@ -223,60 +324,54 @@ static long write_ao(aoRecord *precord)
         double val = precord->val;
         // todo : consider ASLO and AOFF field
 
-        int64_t lval;
-        memcpy(&lval, &val, sizeof(double));
-
         // for (device == 'A')
-        ldata[0] = (uint32_t)(lval>> 0);
-        ldata[1] = (uint32_t)(lval>>32);
+        devF3RP61double2longs(val, ldata);
 
         // for (device != 'A')
-        wdata[0] = (uint16_t)(lval>> 0);
-        wdata[1] = (uint16_t)(lval>>16);
-        wdata[2] = (uint16_t)(lval>>32);
-        wdata[3] = (uint16_t)(lval>>48);
+        devF3RP61double2words(val, wdata);
     } else if (option == 'F') {
         float val = precord->val;
         // todo : consider ASLO and AOFF field
 
-        int32_t lval;
-        memcpy(&lval, &val, sizeof(float));
-
         // for (device == 'A')
-        ldata[0] = (uint32_t)lval;
+        devF3RP61float2longs(val, ldata);
 
         // for (device != 'A')
-        wdata[0] = (uint16_t)(lval>> 0);
-        wdata[1] = (uint16_t)(lval>>16);
+        devF3RP61float2words(val, wdata);
     } else if (option == 'L') {
         // for (device == 'A')
         ldata[0] = (uint32_t)precord->rval;
 
         // for (device != 'A')
-        wdata[0] = (uint16_t)(precord->rval>> 0);
-        wdata[1] = (uint16_t)(precord->rval>>16);
+        devF3RP61long2words(precord->rval, wdata);
     } else {
         wdata[0] = (uint16_t)precord->rval;
     }
 
+    // Skip writing the value last written
+    const int count = (option == 'D') ? 4 : (option == 'F' || option == 'L') ? 2 : 1;
+    if (f3rp61_is_write_unchanged(&dpvt->last, wdata, count)) {
+        return 0;
+    }
+
     // Issue API function
     if (0) {                    // dummy
 
     } else if (device == 'R') { // Shared registers
-        if (writeM3ComRegister(pacom->start, pacom->count, &wdata[0]) < 0) {
+        if (f3rp61_backend->writeM3ComRegister(pacom->start, pacom->count, &wdata[0]) < 0) {
             errlogPrintf("devAoF3RP61: writeM3ComRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'W') { // Link registers
-        if (writeM3LinkRegister(pacom->start, pacom->count, &wdata[0]) < 0) {
+        if (f3rp61_backend->writeM3LinkRegister(pacom->start, pacom->count, &wdata[0]) < 0) {
             errlogPrintf("devAoF3RP61: writeM3LinkRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'r') { // Shared memory
         pacom->pdata = wdata;
-        if (ioctl(f3rp61_fd, M3IO_WRITE_COM, pacom) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_COM, pacom) < 0) {
             errlogPrintf("devAoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -297,26 +392,34 @@ static long write_ao(aoRecord *precord)
             pdrly->u.outrly[3].data = wdata[3];
             pdrly->u.outrly[3].mask = mask[3];
         }
-        if (ioctl(f3rp61_fd, M3IO_WRITE_OUTRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_OUTRELAY, pdrly) < 0) {
             errlogPrintf("devAoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
+    } else if (dpvt->pstage) {  // I/O registers on special modules, staged until committed
+        if (f3rp61_write_stage(dpvt->pstage, pdrly->start, wdata, count) < 0) {
+            errlogPrintf("devAoF3RP61: f3rp61_write_stage failed for %s\n", precord->name);
+            return -1;
+        }
+
     } else {//(device == 'A')   // I/O registers on special modules
         if (option == 'L' || option == 'F' || option == 'D') { // count == 2 || count == 4
             pdrly->u.pldata = ldata;
-            if (ioctl(f3rp61_fd, M3IO_WRITE_REG_L, pdrly) < 0) {
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_REG_L, pdrly) < 0) {
                 errlogPrintf("devAoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
                 return -1;
             }
         } else {
             pdrly->u.pwdata = wdata;
-            if (ioctl(f3rp61_fd, M3IO_WRITE_REG, pdrly) < 0) {
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_REG, pdrly) < 0) {
                 errlogPrintf("devAoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
                 return -1;
             }
         }
     }
 
+    f3rp61_set_last_write(&dpvt->last, wdata, count);
+
     //
     precord->udf = FALSE;
     if (option == 'D' || option == 'F') {
@@ -35,6 +35,7 @@
 #include <aoRecord.h>
 
 #include <drvF3RP61Seq.h>
+#include <devF3RP61conv.h>
 
 // Create the dset for devAoF3RP61Seq
 static long init_record();
@@ -128,7 +129,7 @@ static long init_record(aoRecord *precord)
     }
 
     // Read the slot number of CPU module
-    if (ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
         errlogPrintf("devAoF3RP61Seq: ioctl failed [%d] for %s\n", errno, precord->name);
         precord->pact = 1;
         return -1;
@@ -138,35 +139,46 @@ static long init_record(aoRecord *precord)
     F3RP61_SEQ_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_SEQ_DPVT), "calloc failed");
     dpvt->option = option;
 
-    // Compose data structure for I/O request to CPU module
-    MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-    pmcmdStruct->timeOut = 1;
-
-    MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-    pmcmdRequest->formatCode = 0xf1;
-    pmcmdRequest->responseOption = 1;
-    pmcmdRequest->srcSlot = srcSlot;
-    pmcmdRequest->destSlot = destSlot;
-    pmcmdRequest->mainCode = 0x26;
-    pmcmdRequest->subCode = 0x02;
-
-    M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-    pM3WriteSeqdev->accessType = kWord;
+    // Describe the devices accessed by I/O request to CPU module
+    F3RP61_SEQ_ADDR *paddr = &dpvt->addr;
+    paddr->srcSlot = srcSlot;
+    paddr->destSlot = destSlot;
+    paddr->subCode = 0x02; // write
+    paddr->accessType = kWord;
     if (option == 'D') {
-        pM3WriteSeqdev->dataNum = 4;
+        paddr->dataNum = 4;
     } else if (option == 'F' || option == 'L') {
-        pM3WriteSeqdev->dataNum = 2;
+        paddr->dataNum = 2;
     } else {
-        pM3WriteSeqdev->dataNum = 1;
+        paddr->dataNum = 1;
     }
-    pM3WriteSeqdev->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
-    pM3WriteSeqdev->topDevNo = top;
-    pmcmdRequest->dataSize = 10 + pM3WriteSeqdev->accessType * pM3WriteSeqdev->dataNum;
+    paddr->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
+    paddr->topDevNo = top;
 
     //
     callbackSetUser(precord, &dpvt->callback);
     precord->dpvt = dpvt;
 
+    // Start from the value read back from CPU module at iocInit
+    uint16_t wData[4] = {0};
+    if (f3rp61Seq_getReadback(paddr, wData) == 0) {
+        if (option == 'D') {
+            precord->val = devF3RP61words2double(wData);
+            precord->udf = FALSE;
+            return 2; // don't convert
+        } else if (option == 'F') {
+            precord->val = devF3RP61words2float(wData);
+            precord->udf = FALSE;
+            return 2; // don't convert
+        } else if (option == 'L') {
+            precord->rval = (int32_t) devF3RP61words2long(wData);
+        } else if (option == 'U') {
+            precord->rval = wData[0];
+        } else {
+            precord->rval = (int16_t) wData[0];
+        }
+    }
+
     return 0;
 }
 
@@ -184,11 +196,8 @@ static long write_ao(aoRecord *precord)
             return -1;
         }
 
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_RESPONSE *pmcmdResponse = &pmcmdStruct->mcmdResponse;
-
-        if (pmcmdResponse->errorCode) {
-            errlogPrintf("devAoF3RP61Seq: errorCode 0x%04x returned for %s\n", pmcmdResponse->errorCode, precord->name);
+        if (dpvt->errorCode) {
+            errlogPrintf("devAoF3RP61Seq: errorCode 0x%04x returned for %s\n", dpvt->errorCode, precord->name);
             return -1;
         }
 
@@ -196,10 +205,7 @@ static long write_ao(aoRecord *precord)
         precord->udf = FALSE;
 
     } else { // First call (PACT is still FALSE)
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-        M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-        uint16_t *wdata = pM3WriteSeqdev->dataBuff.wData;
+        uint16_t *wdata = dpvt->wData;
 
         //
         const char option = dpvt->option;
@@ -207,12 +213,7 @@ static long write_ao(aoRecord *precord)
             double val = precord->val;
             // todo : consider ASLO and AOFF field
 
-            uint64_t lval;
-            memcpy(&lval, &val, sizeof(double));
-            wdata[0] = (uint16_t)(lval>> 0);
-            wdata[1] = (uint16_t)(lval>>16);
-            wdata[2] = (uint16_t)(lval>>32);
-            wdata[3] = (uint16_t)(lval>>48);
+            devF3RP61double2words(val, wdata);
 
             precord->udf = isnan(val); // does this make sense?
             // it seems that returning 2 (=no conversion) is meaningless
@@ -222,18 +223,14 @@ static long write_ao(aoRecord *precord)
             float val = precord->val;
             // todo : consider ASLO and AOFF field
 
-            uint32_t lval;
-            memcpy(&lval, &val, sizeof(float));
-            wdata[0] = (uint16_t)(lval>> 0);
-            wdata[1] = (uint16_t)(lval>>16);
+            devF3RP61float2words(val, wdata);
 
             precord->udf = isnan(val); // does this make sense?
             // it seems that returning 2 (=no conversion) is meaningless
             //retval = 2; // no conversion
 
         } else if (option == 'L') {
-            wdata[0] = (uint16_t)(precord->rval>> 0);
-            wdata[1] = (uint16_t)(precord->rval>>16);
+            devF3RP61long2words(precord->rval, wdata);
 
         } else if (option == 'U') {
             wdata[0] = (uint16_t)precord->rval;
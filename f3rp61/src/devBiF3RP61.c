@@ -58,13 +58,15 @@ struct {
 epicsExportAddress(dset, devBiF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     union {
         M3IO_ACCESS_RELAY_POINT inrlyp;
         M3IO_ACCESS_REG drly;
     } u;
+    F3RP61_SCAN_CACHE_REF cache;
     char device;
-    //uint16_t start;
+    uint16_t start;
     uint16_t shift;
 } F3RP61_BI_DPVT;
 
@@ -108,6 +110,7 @@ static long init_record(biRecord *precord)
     //}
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':'); // check if SCAN is interrupt based (example: @U0,S3,Y1:U0,S4,X1)
     if (pint) {
         *pint++ = '\0';
@@ -117,7 +120,7 @@ static long init_record(biRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, position) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, position, &intr) < 0) {
             errlogPrintf("devBiF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -139,6 +142,7 @@ static long init_record(biRecord *precord)
 
     // Allocate private data storage area
     F3RP61_BI_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_BI_DPVT), "calloc failed");
+    dpvt->intr = intr;
     dpvt->device = device;
 
     // Check device validity and compose data structure for I/O request
@@ -154,6 +158,15 @@ static long init_record(biRecord *precord)
         pinrlyp->slotno = slotno;
         pinrlyp->position = position;
 
+        // Periodically scanned records share a snapshot of relay words on the slot
+        dpvt->start = ((position - 1) / 16) * 16 + 1;
+        dpvt->shift = ((position - 1) % 16);
+        if (f3rp61_register_scan_cache((dbCommon *) precord, &dpvt->cache, device, unitno, slotno, dpvt->start, 1, 0) < 0) {
+            errlogPrintf("devBiF3RP61: can't register scan cache for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+
     } else if (device == 'Y') {                  // Output relays on I/O modules
         M3IO_ACCESS_REG *pdrly = &dpvt->u.drly;
         pdrly->unitno = unitno;
@@ -183,6 +196,9 @@ static long read_bi(biRecord *precord)
     M3IO_ACCESS_REG *pdrly = &dpvt->u.drly;
     const char device = dpvt->device;
 
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
     // Buffers for data read
     uint8_t cdata = 0;
     uint8_t wdata = 0;
@@ -191,21 +207,21 @@ static long read_bi(biRecord *precord)
     if (0) {                    // dummy
 
     } else if (device == 'E') { // Shared relays
-        if (readM3ComRelayB(pinrlyp->position, 1, &cdata) < 0) {
+        if (f3rp61_backend->readM3ComRelayB(pinrlyp->position, 1, &cdata) < 0) {
             errlogPrintf("devBiF3RP61: readM3ComRelayB failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
         precord->rval = cdata;
 
     } else if (device == 'L') { // Link realys
-        if (readM3LinkRelayB(pinrlyp->position, 1, &cdata) < 0) {
+        if (f3rp61_backend->readM3LinkRelayB(pinrlyp->position, 1, &cdata) < 0) {
             errlogPrintf("devBiF3RP61: readM3LinkRelayB failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
         precord->rval = cdata;
 
     } else if (device == 'Y') { // Output relay on I/O modules
-        if (ioctl(f3rp61_fd, M3IO_READ_OUTRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_OUTRELAY, pdrly) < 0) {
             errlogPrintf("devBiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -214,8 +230,16 @@ static long read_bi(biRecord *precord)
         wdata &= 0x01;
         precord->rval = wdata;
 
+    } else if (dpvt->cache.pcache) { // Input relays on I/O modules, through scan cache
+        uint16_t word;
+        if (f3rp61_read_scan_cache((dbCommon *) precord, &dpvt->cache, dpvt->start, 1, &word) < 0) {
+            errlogPrintf("devBiF3RP61: f3rp61_read_scan_cache failed [%d] for %s\n", errno, precord->name);
+            return -1;
+        }
+        precord->rval = (word >> dpvt->shift) & 0x01;
+
     } else {//(device == 'X')   // Input relays on I/O modules
-        if (ioctl(f3rp61_fd, M3IO_READ_INRELAY_POINT, pinrlyp) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_INRELAY_POINT, pinrlyp) < 0) {
             errlogPrintf("devBiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -144,7 +144,7 @@ static long read_bi(biRecord *precord)
     if (0) {                    // dummy
 
     } else if (device == 'L') { // LED
-        if (ioctl(f3rp61SysCtl_fd, M3SC_GET_LED, &data) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61SysCtl_fd, M3SC_GET_LED, &data) < 0) {
             errlogPrintf("devBiF3RP61SysCtl: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -158,7 +158,7 @@ static long read_bi(biRecord *precord)
 
 #ifdef M3SC_LED_US3_ON // it is assumed that US1 and US2 are also defined
     } else if (device == 'U') { // User-LED
-        if (ioctl(f3rp61SysCtl_fd, M3SC_GET_US_LED, &data) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61SysCtl_fd, M3SC_GET_US_LED, &data) < 0) {
             errlogPrintf("devBiF3RP61SysCtl: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -172,7 +172,7 @@ static long read_bi(biRecord *precord)
 #endif
 
     } else {//(device == 'R')   // Status Register
-        if (ioctl(f3rp61SysCtl_fd, M3SC_CHECK_BAT, &data) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61SysCtl_fd, M3SC_CHECK_BAT, &data) < 0) {
             errlogPrintf("devBiF3RP61SysCtl: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
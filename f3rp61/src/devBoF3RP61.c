@@ -58,8 +58,13 @@ struct {
 epicsExportAddress(dset, devBoF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     M3IO_ACCESS_RELAY_POINT outrlyp;
+    F3RP61_OUT_GROUP_REF group;
+    F3RP61_LAST_WRITE last;
+    F3RP61_STAGE *pstage; // registers to commit
+    F3RP61_OUT_GROUP *pflush; // output group to flush
     char device;
 } F3RP61_BO_DPVT;
 
@@ -70,6 +75,7 @@ static long init_record(boRecord *precord)
 {
     int unitno = 0, slotno = 0, position = 0;
     char device = 0;
+    char option = 0;
 
     // Link type must be INST_IO
     if (precord->out.type != INST_IO) {
@@ -85,24 +91,32 @@ static long init_record(boRecord *precord)
     strncpy(buf, plink->value.instio.string, size);
     buf[size - 1] = '\0';
 
+    // Parse option to skip writing unchanged values, which may come along
+    // with another option
+    const int suppress = f3rp61_parse_suppress_option(buf);
+
+    // Parse option to commit the registers staged on a module
+    const int staged = f3rp61_parse_staged_option(buf);
+
     // Parse option
-    //char *popt = strchr(buf, '&');
-    //if (popt) {
-    //    char option = 'W'; // Dummy option for Word access
-    //    *popt++ = '\0';
-    //    if (sscanf(popt, "%c", &option) < 1) {
-    //        errlogPrintf("devBoF3RP61: can't get option for %s\n", precord->name);
-    //        precord->pact = 1;
-    //        return -1;
-    //    }
-    //    if (1) {                    // Option not recognized
-    //        errlogPrintf("devBoF3RP61: unsupported option \'%c\' for %s\n", option, precord->name);
-    //        precord->pact = 1;
-    //       return -1;
-    //   }
-    //}
+    char *popt = strchr(buf, '&');
+    if (popt) {
+        *popt++ = '\0';
+        if (sscanf(popt, "%c", &option) < 1) {
+            errlogPrintf("devBoF3RP61: can't get option for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+        if (option == 'G') {        // Write through the output group of the module
+        } else {                    // Option not recognized
+            errlogPrintf("devBoF3RP61: unsupported option \'%c\' for %s\n", option, precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+    }
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':'); // check if SCAN is interrupt based (example: @U0,S3,Y1:U0,S4,X1)
     if (pint) {
         *pint++ = '\0';
@@ -112,15 +126,30 @@ static long init_record(boRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, position) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, position, &intr) < 0) {
             errlogPrintf("devBoF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
         }
     }
 
-    // Parse slot, device and relay number
-    if (sscanf(buf, "U%d,S%d,%c%d", &unitno, &slotno, &device, &position) < 4) {
+    // Parse slot, device and relay number, or slot of the registers to
+    // commit (example: @U0,S4,A&T) or of the output group to flush
+    // (example: @U0,S2,Y&G)
+    const int flush = (option == 'G' && sscanf(buf, "U%d,S%d,%c%d", &unitno, &slotno, &device, &position) < 4);
+    if (staged) {
+        if (sscanf(buf, "U%d,S%d,%c", &unitno, &slotno, &device) < 3 || device != 'A') {
+            errlogPrintf("devBoF3RP61: can't get registers to commit for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+    } else if (flush) {
+        if (sscanf(buf, "U%d,S%d,%c", &unitno, &slotno, &device) < 3 || device != 'Y') {
+            errlogPrintf("devBoF3RP61: can't get output group to flush for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+    } else if (sscanf(buf, "U%d,S%d,%c%d", &unitno, &slotno, &device, &position) < 4) {
         if (sscanf(buf, "%c%d", &device, &position) < 2) {
             errlogPrintf("devBoF3RP61: can't get I/O address for %s\n", precord->name);
             precord->pact = 1;
@@ -132,8 +161,17 @@ static long init_record(boRecord *precord)
         }
     }
 
+    // Only output relays are written through the output group
+    if (option == 'G' && device != 'Y') {
+        errlogPrintf("devBoF3RP61: option \'%c\' is not supported for device \'%c\' of %s\n", option, device, precord->name);
+        precord->pact = 1;
+        return -1;
+    }
+
     // Allocate private data storage area
     F3RP61_BO_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_BO_DPVT), "calloc failed");
+    dpvt->intr = intr;
+    dpvt->last.enabled = suppress;
     dpvt->device = device;
 
     // Check device validity and compose data structure for I/O request
@@ -149,6 +187,28 @@ static long init_record(boRecord *precord)
         poutrlyp->slotno = slotno;
         poutrlyp->position = position;
 
+        if (flush) {
+            if (f3rp61_register_out_group_flush((dbCommon *) precord, &dpvt->pflush, unitno, slotno) < 0) {
+                errlogPrintf("devBoF3RP61: can't register output group flush for %s\n", precord->name);
+                precord->pact = 1;
+                return -1;
+            }
+        } else if (option == 'G') {
+            const int start = position - (position - 1) % 16; // first relay of the word
+            if (f3rp61_register_out_group((dbCommon *) precord, &dpvt->group, unitno, slotno, start) < 0) {
+                errlogPrintf("devBoF3RP61: can't register output group for %s\n", precord->name);
+                precord->pact = 1;
+                return -1;
+            }
+        }
+
+    } else if (device == 'A') {                  // Commit of I/O registers staged
+        if (f3rp61_register_stage((dbCommon *) precord, &dpvt->pstage, unitno, slotno, 0, 0) < 0) {
+            errlogPrintf("devBoF3RP61: can't register staged registers for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+
     } else {
         errlogPrintf("devBoF3RP61: unsupported device \'%c\' for %s\n", device, precord->name);
         precord->pact = 1;
@@ -157,43 +217,120 @@ static long init_record(boRecord *precord)
 
     precord->dpvt = dpvt;
 
+    // Start from the relay read back from the module at iocInit
+    uint16_t wdata = 0;
+    if (device == 'Y' && !flush &&
+        f3rp61_get_readback(device, unitno, slotno, position - (position - 1) % 16, 1, &wdata) == 0) {
+        const uint16_t bit = (wdata >> ((position - 1) % 16)) & 1;
+        f3rp61_set_last_write(&dpvt->last, &bit, 1);
+        precord->rval = bit;
+    }
+
     return 0;
 }
 
 // write_bo() is called when there was a request to process a record.
 // When called, it sends the value from the VAL field to the driver.
+// Writes through the output group complete asynchronously, when the
+// group has been flushed. The commit record writes the registers staged,
+// and the flush record writes the output group.
 static long write_bo(boRecord *precord)
 {
     F3RP61_BO_DPVT *dpvt = precord->dpvt;
     M3IO_ACCESS_RELAY_POINT *poutrlyp = &dpvt->outrlyp;
     const char device = dpvt->device;
 
+    if (precord->pact) { // Second call, after the output group was flushed
+        if (dpvt->group.ret < 0) {
+            errlogPrintf("devBoF3RP61: output group write failed for %s\n", precord->name);
+            return -1;
+        }
+
+        const uint16_t wdata = (uint8_t) precord->rval;
+        f3rp61_set_last_write(&dpvt->last, &wdata, 1);
+
+        //
+        precord->udf = FALSE;
+
+        return 0;
+    }
+
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
+    // Commit the registers staged, whatever the value
+    if (device == 'A') {
+        if (f3rp61_commit_stage(dpvt->pstage) < 0) {
+            errlogPrintf("devBoF3RP61: f3rp61_commit_stage failed [%d] for %s\n", errno, precord->name);
+            return -1;
+        }
+
+        //
+        precord->udf = FALSE;
+
+        return 0;
+    }
+
+    // Flush the output group, whatever the value
+    if (dpvt->pflush) {
+        if (f3rp61_flush_out_group(dpvt->pflush) < 0) {
+            errlogPrintf("devBoF3RP61: f3rp61_flush_out_group failed [%d] for %s\n", errno, precord->name);
+            return -1;
+        }
+
+        //
+        precord->udf = FALSE;
+
+        return 0;
+    }
+
     // Compose data to write
     uint8_t cdata = precord->rval;
+    const uint16_t wdata = cdata;
+
+    // Skip writing the value last written
+    if (f3rp61_is_write_unchanged(&dpvt->last, &wdata, 1)) {
+        return 0;
+    }
 
     // Issue API function
     if (0) {                    // dummy
 
     } else if (device == 'E') { // Shared relays
-        if (writeM3ComRelayB(poutrlyp->position, 1, &cdata) < 0) {
+        if (f3rp61_backend->writeM3ComRelayB(poutrlyp->position, 1, &cdata) < 0) {
             errlogPrintf("devBoF3RP61: writeM3ComRelayB failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'L') { // Link relays
-        if (writeM3LinkRelayB(poutrlyp->position, 1, &cdata) < 0) {
+        if (f3rp61_backend->writeM3LinkRelayB(poutrlyp->position, 1, &cdata) < 0) {
             errlogPrintf("devBoF3RP61: writeM3LinkRelayB failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
+    } else if (dpvt->group.pgroup) { // Relays on I/O modules, through the output group
+        const int bit = (poutrlyp->position - 1) % 16;
+        const uint16_t mask = 1 << bit;
+        if (f3rp61_write_out_group((dbCommon *) precord, &dpvt->group, poutrlyp->position - bit,
+                                   cdata ? mask : 0, mask) < 0) {
+            errlogPrintf("devBoF3RP61: f3rp61_write_out_group failed for %s\n", precord->name);
+            return -1;
+        }
+
+        precord->pact = 1;
+
+        return 0;
+
     } else {//(device == 'Y')   // Relays on I/O modules
         poutrlyp->data = cdata;
-        if (ioctl(f3rp61_fd, M3IO_WRITE_OUTRELAY_POINT, poutrlyp) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_OUTRELAY_POINT, poutrlyp) < 0) {
             errlogPrintf("devBoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
     }
 
+    f3rp61_set_last_write(&dpvt->last, &wdata, 1);
+
     //
     precord->udf = FALSE;
 
@@ -98,7 +98,7 @@ static long init_record(boRecord *precord)
     }
 
     // Read the slot number of CPU module
-    if (ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
         errlogPrintf("devBoF3RP61Seq: ioctl failed [%d] for %s\n", errno, precord->name);
         precord->pact = 1;
         return -1;
@@ -107,29 +107,26 @@ static long init_record(boRecord *precord)
     // Allocate private data storage area
     F3RP61_SEQ_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_SEQ_DPVT), "calloc failed");
 
-    // Compose data structure for I/O request to CPU module
-    MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-    pmcmdStruct->timeOut = 1;
-
-    MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-    pmcmdRequest->formatCode = 0xf1;
-    pmcmdRequest->responseOption = 1;
-    pmcmdRequest->srcSlot = srcSlot;
-    pmcmdRequest->destSlot = destSlot;
-    pmcmdRequest->mainCode = 0x26;
-    pmcmdRequest->subCode = 0x02;
-    pmcmdRequest->dataSize = 12;
-
-    M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-    pM3WriteSeqdev->accessType = kBit;
-    pM3WriteSeqdev->dataNum = 1;
-    pM3WriteSeqdev->devType = device - '@'; // 'I'=>0x09, 'M'=>0x0D
-    pM3WriteSeqdev->topDevNo = top;
+    // Describe the devices accessed by I/O request to CPU module
+    F3RP61_SEQ_ADDR *paddr = &dpvt->addr;
+    paddr->srcSlot = srcSlot;
+    paddr->destSlot = destSlot;
+    paddr->subCode = 0x02; // write
+    paddr->accessType = kBit;
+    paddr->dataNum = 1;
+    paddr->devType = device - '@'; // 'I'=>0x09, 'M'=>0x0D
+    paddr->topDevNo = top;
 
     //
     callbackSetUser(precord, &dpvt->callback);
     precord->dpvt = dpvt;
 
+    // Start from the relay read back from CPU module at iocInit
+    uint16_t wData = 0;
+    if (f3rp61Seq_getReadback(paddr, &wData) == 0) {
+        precord->rval = wData ? 1 : 0;
+    }
+
     return 0;
 }
 
@@ -146,11 +143,8 @@ static long write_bo(boRecord *precord)
             return -1;
         }
 
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_RESPONSE *pmcmdResponse = &pmcmdStruct->mcmdResponse;
-
-        if (pmcmdResponse->errorCode) {
-            errlogPrintf("devBoF3RP61Seq: errorCode 0x%04x returned for %s\n", pmcmdResponse->errorCode, precord->name);
+        if (dpvt->errorCode) {
+            errlogPrintf("devBoF3RP61Seq: errorCode 0x%04x returned for %s\n", dpvt->errorCode, precord->name);
             return -1;
         }
 
@@ -158,12 +152,8 @@ static long write_bo(boRecord *precord)
         precord->udf = FALSE;
 
     } else { // First call (PACT is still FALSE)
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-        M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-
         //
-        pM3WriteSeqdev->dataBuff.wData[0] = (unsigned short) precord->rval;
+        dpvt->wData[0] = (unsigned short) precord->rval;
 
         // Issue write request
         if (f3rp61Seq_queueRequest(dpvt) < 0) {
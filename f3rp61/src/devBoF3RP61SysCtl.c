@@ -151,7 +151,7 @@ static long write_bo(boRecord *precord)
         } else {//(led == 'E')
             data = (precord->val) ? M3SC_LED_ERR_ON : M3SC_LED_ERR_OFF;
         }
-        if (ioctl(f3rp61SysCtl_fd, M3SC_SET_LED, &data) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61SysCtl_fd, M3SC_SET_LED, &data) < 0) {
             errlogPrintf("devBoF3RP61SysCtl: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -165,7 +165,7 @@ static long write_bo(boRecord *precord)
         } else {//(led == '3')
             data = (precord->val) ? M3SC_LED_US3_ON : M3SC_LED_US3_OFF;
         }
-        if (ioctl(f3rp61SysCtl_fd, M3SC_SET_US_LED, &data) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61SysCtl_fd, M3SC_SET_US_LED, &data) < 0) {
             errlogPrintf("devBoF3RP61SysCtl: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
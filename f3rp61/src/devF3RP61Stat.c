@@ -0,0 +1,241 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* devF3RP61Stat.c - Statistics Helper Routines for F3RP61
+*
+*      Date: 2026 Oct. 16
+*/
+
+//
+#include <stdio.h>
+#include <string.h>
+
+//
+#include <dbCommon.h>
+#include <dbScan.h>
+
+//
+#include <devF3RP61Stat.h>
+
+// Statistics items
+enum {
+    STAT_RECEIVED,
+    STAT_OVERRUN,
+    STAT_ERROR,
+    STAT_UNMATCHED,
+    STAT_REQ_MIN,
+    STAT_REQ_MEAN,
+    STAT_REQ_MAX,
+    STAT_REQ_HIST,
+    STAT_DONE_MIN,
+    STAT_DONE_MEAN,
+    STAT_DONE_MAX,
+    STAT_DONE_HIST,
+    STAT_SEQ_REQUESTS,
+    STAT_SEQ_COMMANDS,
+    STAT_SEQ_ERRORS,
+    STAT_SEQ_RATE,
+    STAT_SEQ_QUEUED,
+    STAT_SEQ_QUEUED_MAX,
+    STAT_SEQ_WAIT_MIN,
+    STAT_SEQ_WAIT_MEAN,
+    STAT_SEQ_WAIT_MAX,
+    STAT_SEQ_WAIT_HIST,
+    STAT_SEQ_SERVICE_MIN,
+    STAT_SEQ_SERVICE_MEAN,
+    STAT_SEQ_SERVICE_MAX,
+    STAT_SEQ_SERVICE_HIST,
+};
+
+static const struct {
+    char source;
+    const char *name;
+    int item;
+} items[] = {
+    {'I', "RECEIVED",     STAT_RECEIVED},
+    {'I', "OVERRUN",      STAT_OVERRUN},
+    {'I', "ERROR",        STAT_ERROR},
+    {'I', "UNMATCHED",    STAT_UNMATCHED},
+    {'I', "REQ_MIN",      STAT_REQ_MIN},
+    {'I', "REQ_MEAN",     STAT_REQ_MEAN},
+    {'I', "REQ_MAX",      STAT_REQ_MAX},
+    {'I', "REQ_HIST",     STAT_REQ_HIST},
+    {'I', "DONE_MIN",     STAT_DONE_MIN},
+    {'I', "DONE_MEAN",    STAT_DONE_MEAN},
+    {'I', "DONE_MAX",     STAT_DONE_MAX},
+    {'I', "DONE_HIST",    STAT_DONE_HIST},
+    {'S', "REQUESTS",     STAT_SEQ_REQUESTS},
+    {'S', "COMMANDS",     STAT_SEQ_COMMANDS},
+    {'S', "ERROR",        STAT_SEQ_ERRORS},
+    {'S', "RATE",         STAT_SEQ_RATE},
+    {'S', "QUEUED",       STAT_SEQ_QUEUED},
+    {'S', "QUEUED_MAX",   STAT_SEQ_QUEUED_MAX},
+    {'S', "WAIT_MIN",     STAT_SEQ_WAIT_MIN},
+    {'S', "WAIT_MEAN",    STAT_SEQ_WAIT_MEAN},
+    {'S', "WAIT_MAX",     STAT_SEQ_WAIT_MAX},
+    {'S', "WAIT_HIST",    STAT_SEQ_WAIT_HIST},
+    {'S', "SERVICE_MIN",  STAT_SEQ_SERVICE_MIN},
+    {'S', "SERVICE_MEAN", STAT_SEQ_SERVICE_MEAN},
+    {'S', "SERVICE_MAX",  STAT_SEQ_SERVICE_MAX},
+    {'S', "SERVICE_HIST", STAT_SEQ_SERVICE_HIST},
+};
+
+static long get_seq_value(const F3RP61_STAT_ADDR *, double *);
+static long get_seq_hist(const F3RP61_STAT_ADDR *, unsigned long *);
+
+// Parse the INP field string
+long devF3RP61StatParse(const char *buf, F3RP61_STAT_ADDR *paddr)
+{
+    char name[32] = {0};
+
+    memset(paddr, 0, sizeof(F3RP61_STAT_ADDR));
+
+    if (0) {                                                  // dummy
+
+    } else if (sscanf(buf, "INTR,U%d,S%d,X%d,%31s", &paddr->unit, &paddr->slot, &paddr->channel, name) == 4) {
+        paddr->source = 'I';
+
+    } else if (sscanf(buf, "INTR,%31s", name) == 1) {
+        paddr->source = 'I';
+        paddr->unit   = -1;
+
+    } else if (sscanf(buf, "SEQ,CPU%d,%31s", &paddr->slot, name) == 2) {
+        paddr->source = 'S';
+
+    } else if (sscanf(buf, "SEQ,%31s", name) == 1) {
+        paddr->source = 'S';
+        paddr->slot   = 0;
+
+    } else {
+        return -1;
+    }
+
+    for (size_t i = 0; i < sizeof(items) / sizeof(items[0]); i++) {
+        if (items[i].source == paddr->source && strcmp(name, items[i].name) == 0) {
+            paddr->item = items[i].item;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int devF3RP61StatIsHist(const F3RP61_STAT_ADDR *paddr)
+{
+    return paddr->item == STAT_REQ_HIST || paddr->item == STAT_DONE_HIST ||
+           paddr->item == STAT_SEQ_WAIT_HIST || paddr->item == STAT_SEQ_SERVICE_HIST;
+}
+
+// Get the value of a scalar item
+long devF3RP61StatGetValue(const F3RP61_STAT_ADDR *paddr, double *pval)
+{
+    if (paddr->source == 'S') {
+        return get_seq_value(paddr, pval);
+    }
+
+    F3RP61_IO_INTR_STAT stat;
+
+    if (f3rp61_get_io_interrupt_stat(paddr->unit, paddr->slot, paddr->channel, &stat) < 0) {
+        return -1;
+    }
+
+    switch (paddr->item) {
+    case STAT_RECEIVED:  *pval = stat.received;                          break;
+    case STAT_OVERRUN:   *pval = stat.overruns;                          break;
+    case STAT_ERROR:     *pval = stat.errors;                            break;
+    case STAT_UNMATCHED: *pval = stat.unmatched;                         break;
+    case STAT_REQ_MIN:   *pval = stat.request.min;                       break;
+    case STAT_REQ_MEAN:  *pval = f3rp61_latency_mean(&stat.request);     break;
+    case STAT_REQ_MAX:   *pval = stat.request.max;                       break;
+    case STAT_DONE_MIN:  *pval = stat.complete.min;                      break;
+    case STAT_DONE_MEAN: *pval = f3rp61_latency_mean(&stat.complete);    break;
+    case STAT_DONE_MAX:  *pval = stat.complete.max;                      break;
+    default:
+        return -1;
+    }
+
+    return 0;
+}
+
+// Get the histogram of F3RP61_LATENCY_NBINS bins
+long devF3RP61StatGetHist(const F3RP61_STAT_ADDR *paddr, unsigned long *hist)
+{
+    if (paddr->source == 'S') {
+        return get_seq_hist(paddr, hist);
+    }
+
+    F3RP61_IO_INTR_STAT stat;
+
+    if (f3rp61_get_io_interrupt_stat(paddr->unit, paddr->slot, paddr->channel, &stat) < 0) {
+        return -1;
+    }
+
+    switch (paddr->item) {
+    case STAT_REQ_HIST:
+        memcpy(hist, stat.request.hist, sizeof(stat.request.hist));
+        break;
+    case STAT_DONE_HIST:
+        memcpy(hist, stat.complete.hist, sizeof(stat.complete.hist));
+        break;
+    default:
+        return -1;
+    }
+
+    return 0;
+}
+
+// Get the value of a scalar item of sequence CPUs
+static long get_seq_value(const F3RP61_STAT_ADDR *paddr, double *pval)
+{
+    F3RP61_SEQ_STAT stat;
+
+    if (f3rp61Seq_getStat(paddr->slot, &stat) < 0) {
+        return -1;
+    }
+
+    switch (paddr->item) {
+    case STAT_SEQ_REQUESTS:     *pval = stat.requests;                      break;
+    case STAT_SEQ_COMMANDS:     *pval = stat.commands;                      break;
+    case STAT_SEQ_ERRORS:       *pval = stat.errors;                        break;
+    case STAT_SEQ_RATE:         *pval = stat.rate;                          break;
+    case STAT_SEQ_QUEUED:       *pval = stat.queued;                        break;
+    case STAT_SEQ_QUEUED_MAX:   *pval = stat.queued_max;                    break;
+    case STAT_SEQ_WAIT_MIN:     *pval = stat.wait.min;                      break;
+    case STAT_SEQ_WAIT_MEAN:    *pval = f3rp61_latency_mean(&stat.wait);    break;
+    case STAT_SEQ_WAIT_MAX:     *pval = stat.wait.max;                      break;
+    case STAT_SEQ_SERVICE_MIN:  *pval = stat.service.min;                   break;
+    case STAT_SEQ_SERVICE_MEAN: *pval = f3rp61_latency_mean(&stat.service); break;
+    case STAT_SEQ_SERVICE_MAX:  *pval = stat.service.max;                   break;
+    default:
+        return -1;
+    }
+
+    return 0;
+}
+
+// Get the histogram of sequence CPUs
+static long get_seq_hist(const F3RP61_STAT_ADDR *paddr, unsigned long *hist)
+{
+    F3RP61_SEQ_STAT stat;
+
+    if (f3rp61Seq_getStat(paddr->slot, &stat) < 0) {
+        return -1;
+    }
+
+    switch (paddr->item) {
+    case STAT_SEQ_WAIT_HIST:
+        memcpy(hist, stat.wait.hist, sizeof(stat.wait.hist));
+        break;
+    case STAT_SEQ_SERVICE_HIST:
+        memcpy(hist, stat.service.hist, sizeof(stat.service.hist));
+        break;
+    default:
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,23 @@
+#ifndef DEVF3RP61STAT_H
+#define DEVF3RP61STAT_H
+
+#include <drvF3RP61.h>
+#include <drvF3RP61Seq.h>
+
+// Address of a statistic given in the INP field of the records of
+// DTYP "F3RP61Stat", e.g. "@INTR,U0,S2,X1,REQ_MEAN", "@INTR,ERROR" or
+// "@SEQ,CPU1,WAIT_MAX"
+typedef struct {
+    char source;  // 'I' for interrupts, 'S' for sequence CPUs
+    int unit;     // -1 for the sum over all the channels
+    int slot;     // of sequence CPU, 0 for the sum over all the CPUs
+    int channel;
+    int item;
+} F3RP61_STAT_ADDR;
+
+long devF3RP61StatParse(const char *, F3RP61_STAT_ADDR *);
+int  devF3RP61StatIsHist(const F3RP61_STAT_ADDR *);
+long devF3RP61StatGetValue(const F3RP61_STAT_ADDR *, double *);
+long devF3RP61StatGetHist(const F3RP61_STAT_ADDR *, unsigned long *);
+
+#endif
@@ -0,0 +1,171 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* devF3RP61conv.c - Word Order Conversion Routines for F3RP61
+*
+*      Date: 2026 Oct. 16
+*/
+
+//
+#include <stdint.h>
+#include <string.h>
+
+//
+#include <epicsEndian.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define HAS_NEON
+#endif
+
+//
+#include <devF3RP61conv.h>
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Single values
+//
+uint32_t devF3RP61words2long(const uint16_t *wdata)
+{
+    return ((uint32_t) wdata[1] << 16) | wdata[0];
+}
+
+float devF3RP61words2float(const uint16_t *wdata)
+{
+    const uint32_t lval = devF3RP61words2long(wdata);
+    float val;
+    memcpy(&val, &lval, sizeof(float));
+    return val;
+}
+
+double devF3RP61words2double(const uint16_t *wdata)
+{
+    const uint64_t lval = ((uint64_t) wdata[3] << 48) | ((uint64_t) wdata[2] << 32) |
+                          ((uint64_t) wdata[1] << 16) | wdata[0];
+    double val;
+    memcpy(&val, &lval, sizeof(double));
+    return val;
+}
+
+void devF3RP61long2words(uint32_t lval, uint16_t *wdata)
+{
+    wdata[0] = (uint16_t)(lval >>  0);
+    wdata[1] = (uint16_t)(lval >> 16);
+}
+
+void devF3RP61float2words(float val, uint16_t *wdata)
+{
+    uint32_t lval;
+    memcpy(&lval, &val, sizeof(float));
+    devF3RP61long2words(lval, wdata);
+}
+
+void devF3RP61double2words(double val, uint16_t *wdata)
+{
+    uint64_t lval;
+    memcpy(&lval, &val, sizeof(double));
+    wdata[0] = (uint16_t)(lval >>  0);
+    wdata[1] = (uint16_t)(lval >> 16);
+    wdata[2] = (uint16_t)(lval >> 32);
+    wdata[3] = (uint16_t)(lval >> 48);
+}
+
+float devF3RP61longs2float(const unsigned long *ldata)
+{
+    const uint32_t lval = ldata[0];
+    float val;
+    memcpy(&val, &lval, sizeof(float));
+    return val;
+}
+
+double devF3RP61longs2double(const unsigned long *ldata)
+{
+    const uint64_t lval = ((uint64_t)(uint32_t) ldata[1] << 32) | (uint32_t) ldata[0];
+    double val;
+    memcpy(&val, &lval, sizeof(double));
+    return val;
+}
+
+void devF3RP61float2longs(float val, unsigned long *ldata)
+{
+    uint32_t lval;
+    memcpy(&lval, &val, sizeof(float));
+    ldata[0] = lval;
+}
+
+void devF3RP61double2longs(double val, unsigned long *ldata)
+{
+    uint64_t lval;
+    memcpy(&lval, &val, sizeof(double));
+    ldata[0] = (uint32_t)(lval >>  0);
+    ldata[1] = (uint32_t)(lval >> 32);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Arrays
+//
+// Join pairs of words, lower word first, into 32-bit values in place.
+// The words are already in order on little-endian CPUs.
+//
+void devF3RP61wordsJoin(uint16_t *wdata, int nelm)
+{
+#if EPICS_BYTE_ORDER != EPICS_ENDIAN_LITTLE
+    for (int i = 0; i < nelm; i++) {
+        const uint16_t lower = wdata[2 * i];
+        wdata[2 * i] = wdata[2 * i + 1];
+        wdata[2 * i + 1] = lower;
+    }
+#endif
+}
+
+// Reverse the order of the nwords (2 or 4) words of each value in place,
+// storing each word in big-endian. On little-endian CPUs this amounts
+// to reversing the bytes of each value, done 16 bytes at a time with
+// NEON where available.
+//
+void devF3RP61wordsReverse(uint16_t *wdata, int nelm, int nwords)
+{
+    int i = 0;
+
+#if EPICS_BYTE_ORDER == EPICS_ENDIAN_LITTLE
+    const int nbytes = 2 * nwords;
+    uint8_t *pbyte = (uint8_t *) wdata;
+#  if defined(HAS_NEON)
+    const int step = 16 / nbytes; // values in a vector
+    for (; i + step <= nelm; i += step) {
+        uint8x16_t v = vld1q_u8(&pbyte[nbytes * i]);
+        v = (nwords == 4) ? vrev64q_u8(v) : vrev32q_u8(v);
+        vst1q_u8(&pbyte[nbytes * i], v);
+    }
+#  endif
+    if (nwords == 4) {
+        for (; i < nelm; i++) {
+            uint64_t lval;
+            memcpy(&lval, &pbyte[nbytes * i], sizeof(lval));
+            lval = __builtin_bswap64(lval);
+            memcpy(&pbyte[nbytes * i], &lval, sizeof(lval));
+        }
+    } else {
+        for (; i < nelm; i++) {
+            uint32_t lval;
+            memcpy(&lval, &pbyte[nbytes * i], sizeof(lval));
+            lval = __builtin_bswap32(lval);
+            memcpy(&pbyte[nbytes * i], &lval, sizeof(lval));
+        }
+    }
+#else
+    for (; i < nelm; i++) {
+        uint16_t *pelem = &wdata[nwords * i];
+        for (int j = 0; j < nwords / 2; j++) {
+            const uint16_t lower = pelem[j];
+            pelem[j] = pelem[nwords - 1 - j];
+            pelem[nwords - 1 - j] = lower;
+        }
+    }
+#endif
+}
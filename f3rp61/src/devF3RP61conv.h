@@ -0,0 +1,28 @@
+#ifndef DEVF3RP61CONV_H
+#define DEVF3RP61CONV_H
+
+#include <stdint.h>
+
+// Conversion between 16-bit words on devices and values of 32/64 bits.
+// A value of 2 or 4 words is stored lower word first on devices, as is
+// the case with the &L, &F and &D options.
+
+// Single values
+uint32_t devF3RP61words2long(const uint16_t *wdata);
+float    devF3RP61words2float(const uint16_t *wdata);
+double   devF3RP61words2double(const uint16_t *wdata);
+void     devF3RP61long2words(uint32_t lval, uint16_t *wdata);
+void     devF3RP61float2words(float val, uint16_t *wdata);
+void     devF3RP61double2words(double val, uint16_t *wdata);
+
+// Values read by M3IO_READ_REG_L, lower long word first
+float    devF3RP61longs2float(const unsigned long *ldata);
+double   devF3RP61longs2double(const unsigned long *ldata);
+void     devF3RP61float2longs(float val, unsigned long *ldata);
+void     devF3RP61double2longs(double val, unsigned long *ldata);
+
+// Arrays, converted in place
+void     devF3RP61wordsJoin(uint16_t *wdata, int nelm);
+void     devF3RP61wordsReverse(uint16_t *wdata, int nelm, int nwords);
+
+#endif
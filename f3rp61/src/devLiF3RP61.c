@@ -38,6 +38,7 @@
 
 #include <drvF3RP61.h>
 #include <devF3RP61bcd.h>
+#include <devF3RP61conv.h>
 
 // Create the dset for devLiF3RP61
 static long init_record();
@@ -64,11 +65,13 @@ struct {
 epicsExportAddress(dset, devLiF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     union {
         M3IO_ACCESS_COM acom;
         M3IO_ACCESS_REG drly;
     } u;
+    F3RP61_SCAN_CACHE_REF cache;
     char device;
     char option;
 } F3RP61_LI_DPVT;
@@ -118,6 +121,7 @@ static long init_record(longinRecord *precord)
     }
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':'); // check if SCAN is interrupt based (example: @U0,S3,Y1:U0,S4,X1)
     if (pint) {
         *pint++ = '\0';
@@ -127,7 +131,7 @@ static long init_record(longinRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start, &intr) < 0) {
             errlogPrintf("devLiF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -153,6 +157,7 @@ static long init_record(longinRecord *precord)
 
     // Allocate private data storage area
     F3RP61_LI_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_LI_DPVT), "calloc failed");
+    dpvt->intr = intr;
     dpvt->device = device;
     dpvt->option = option;
 
@@ -209,6 +214,14 @@ static long init_record(longinRecord *precord)
         pdrly->start  = start;
         pdrly->count  = 1; // we use M3IO_READ_REG_L for 'L' option therefore count must be always 1
 
+        // Periodically scanned records share a snapshot of registers on the slot
+        if (f3rp61_register_scan_cache((dbCommon *) precord, &dpvt->cache, device, unitno, slotno, start, count,
+                                       option == 'L') < 0) {
+            errlogPrintf("devLiF3RP61: can't register scan cache for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+
     } else {
         errlogPrintf("devLiF3RP61: unsupported device \'%c\' for %s\n", device, precord->name);
         precord->pact = 1;
@@ -231,6 +244,9 @@ static long read_longin(longinRecord *precord)
     const char device = dpvt->device;
     const char option = dpvt->option;
 
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
     // Buffers for data read
     uint16_t wdata[2] = {0};
     ulong    ldata[1] = {0};
@@ -239,25 +255,25 @@ static long read_longin(longinRecord *precord)
     if (0) {                    // dummy
 
     } else if (device == 'R') { // Shared registers
-        if (readM3ComRegister(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3ComRegister(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLiF3RP61: readM3ComRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'W') { // Link registers
-        if (readM3LinkRegister(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3LinkRegister(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLiF3RP61: readM3LinkRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'E') { // Shared relays
-        if (readM3ComRelay(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3ComRelay(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLiF3RP61: readM3ComRelay failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'L') { // Link relays
-        if (readM3LinkRelay(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3LinkRelay(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLiF3RP61: readM3LinkRelay failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -265,19 +281,19 @@ static long read_longin(longinRecord *precord)
     } else if (device == 'r') { // Shared memory
 #if defined(__powerpc__)
         pacom->pdata = wdata;
-        if (ioctl(f3rp61_fd, M3IO_READ_COM, pacom) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_COM, pacom) < 0) {
             errlogPrintf("devLiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #else
-        if (readM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLiF3RP61: readM3CpuMemory failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #endif
 
     } else if (device == 'X') { // Input relays on I/O modules
-        if (ioctl(f3rp61_fd, M3IO_READ_INRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_INRELAY, pdrly) < 0) {
             errlogPrintf("devLiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -287,7 +303,7 @@ static long read_longin(longinRecord *precord)
         }
 
     } else if (device == 'Y') { // Output relays on I/O modules
-        if (ioctl(f3rp61_fd, M3IO_READ_OUTRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_OUTRELAY, pdrly) < 0) {
             errlogPrintf("devLiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -309,28 +325,37 @@ static long read_longin(longinRecord *precord)
         // and only the 1st element is valid in the data read out.
         pdrly->start  = 1;
         pdrly->count  = 3;
-        if (ioctl(f3rp61_fd, M3IO_READ_MODE, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_MODE, pdrly) < 0) {
             errlogPrintf("devLiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
         wdata[0] = pdrly->u.wdata[0];
 #else
-        if (readM3IoModeRegister(pdrly->unitno, pdrly->slotno, pdrly->start, pdrly->count, wdata) < 0) {
+        if (f3rp61_backend->readM3IoModeRegister(pdrly->unitno, pdrly->slotno, pdrly->start, pdrly->count, wdata) < 0) {
             errlogPrintf("devLiF3RP61: readM3IoModeRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #endif
 
+    } else if (dpvt->cache.pcache) { // I/O registers on special modules, through scan cache
+        const int count = (option == 'L') ? 2 : 1;
+        if (f3rp61_read_scan_cache((dbCommon *) precord, &dpvt->cache, pdrly->start, count, wdata) < 0) {
+            errlogPrintf("devLiF3RP61: f3rp61_read_scan_cache failed [%d] for %s\n", errno, precord->name);
+            return -1;
+        }
+        // Lower word comes first as is the case with M3IO_READ_REG_L
+        ldata[0] = devF3RP61words2long(wdata);
+
     } else {//(device == 'A') // I/O registers on special modules
         if (option == 'L') {
             pdrly->u.pldata = ldata;
-            if (ioctl(f3rp61_fd, M3IO_READ_REG_L, pdrly) < 0) {
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG_L, pdrly) < 0) {
                 errlogPrintf("devLiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
                 return -1;
             }
         } else {
             pdrly->u.pwdata = wdata;
-            if (ioctl(f3rp61_fd, M3IO_READ_REG, pdrly) < 0) {
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG, pdrly) < 0) {
                 errlogPrintf("devLiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
                 return -1;
             }
@@ -347,7 +372,7 @@ static long read_longin(longinRecord *precord)
         if (device == 'A') {
             precord->val = ldata[0];
         } else {
-            precord->val = (wdata[1]<<16) | wdata[0];
+            precord->val = devF3RP61words2long(wdata);
         }
     } else if (option == 'U') {
         precord->val = (uint16_t)wdata[0];
@@ -38,6 +38,7 @@
 
 #include <drvF3RP61.h>
 #include <devF3RP61bcd.h>
+#include <devF3RP61conv.h>
 
 // Create the dset for devLoF3RP61
 static long init_record();
@@ -64,11 +65,14 @@ struct {
 epicsExportAddress(dset, devLoF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     union {
         M3IO_ACCESS_COM acom;
         M3IO_ACCESS_REG drly;
     } u;
+    F3RP61_LAST_WRITE last;
+    F3RP61_STAGE *pstage; // NULL unless staged until committed
     char device;
     char option;
 } F3RP61_LO_DPVT;
@@ -96,6 +100,14 @@ static long init_record(longoutRecord *precord)
     strncpy(buf, plink->value.instio.string, size);
     buf[size - 1] = '\0';
 
+    // Parse option to skip writing unchanged values, which may come along
+    // with another option
+    const int suppress = f3rp61_parse_suppress_option(buf);
+
+    // Parse option to stage the value until committed, which may come
+    // along with another option
+    const int staged = f3rp61_parse_staged_option(buf);
+
     // Parse option
     char *popt = strchr(buf, '&');
     if (popt) {
@@ -118,6 +130,7 @@ static long init_record(longoutRecord *precord)
     }
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':'); // check if SCAN is interrupt based (example: @U0,S3,Y1:U0,S4,X1)
     if (pint) {
         *pint++ = '\0';
@@ -127,7 +140,7 @@ static long init_record(longoutRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start, &intr) < 0) {
             errlogPrintf("devLoF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -151,8 +164,17 @@ static long init_record(longoutRecord *precord)
         }
     }
 
+    // Only I/O registers are staged
+    if (staged && device != 'A') {
+        errlogPrintf("devLoF3RP61: option \'T\' is not supported for device \'%c\' of %s\n", device, precord->name);
+        precord->pact = 1;
+        return -1;
+    }
+
     // Allocate private data storage area
     F3RP61_LO_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_LO_DPVT), "calloc failed");
+    dpvt->intr = intr;
+    dpvt->last.enabled = suppress;
     dpvt->device = device;
     dpvt->option = option;
 
@@ -209,6 +231,14 @@ static long init_record(longoutRecord *precord)
         pdrly->start  = start;
         pdrly->count  = 1; // we use M3IO_WRITE_REG_L for 'L' option therefore count must be always 1
 
+        if (staged) {
+            if (f3rp61_register_stage((dbCommon *) precord, &dpvt->pstage, unitno, slotno, start, count) < 0) {
+                errlogPrintf("devLoF3RP61: can't register staged registers for %s\n", precord->name);
+                precord->pact = 1;
+                return -1;
+            }
+        }
+
     } else {
         errlogPrintf("devLoF3RP61: unsupported device \'%c\' for %s\n", device, precord->name);
         precord->pact = 1;
@@ -217,6 +247,22 @@ static long init_record(longoutRecord *precord)
 
     precord->dpvt = dpvt;
 
+    // Start from the value read back from the device at iocInit, except
+    // BCD values which may not be valid
+    uint16_t wdata[2] = {0};
+    if ((device == 'R' || device == 'Y' || device == 'A') && option != 'B' &&
+        f3rp61_get_readback(device, unitno, slotno, start, count, wdata) == 0) {
+        f3rp61_set_last_write(&dpvt->last, wdata, count);
+        if (option == 'L') {
+            precord->val = (int32_t) devF3RP61words2long(wdata);
+        } else if (option == 'U') {
+            precord->val = wdata[0];
+        } else {
+            precord->val = (int16_t) wdata[0];
+        }
+        precord->udf = FALSE;
+    }
+
     return 0;
 }
 
@@ -230,6 +276,9 @@ static long write_longout(longoutRecord *precord)
     const char device = dpvt->device;
     const char option = dpvt->option;
 
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
     // Compose data to write
     uint16_t wdata[2] = {0};
     uint16_t mask[2]  = {0xffff, 0xffff};
@@ -241,35 +290,40 @@ static long write_longout(longoutRecord *precord)
         ldata[0] = (uint32_t)precord->val;
 
         // for (device != 'A')
-        wdata[0] = (uint16_t)(precord->val>> 0);
-        wdata[1] = (uint16_t)(precord->val>>16);
+        devF3RP61long2words(precord->val, wdata);
     } else {
         wdata[0] = (uint16_t)precord->val;
     }
 
+    // Skip writing the value last written
+    const int count = (option == 'L') ? 2 : 1;
+    if (f3rp61_is_write_unchanged(&dpvt->last, wdata, count)) {
+        return 0;
+    }
+
     // Issue API function
     if (0) {                    // dummy
 
     } else if (device == 'R') { // Shared registers
-        if (writeM3ComRegister(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->writeM3ComRegister(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLoF3RP61: writeM3ComRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'W') { // Link registers
-        if (writeM3LinkRegister(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->writeM3LinkRegister(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLoF3RP61: writeM3LinkRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'E') { // Shared relays
-        if (writeM3ComRelay(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->writeM3ComRelay(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLoF3RP61: writeM3ComRelay failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'L') { // Link relays
-        if (writeM3LinkRelay(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->writeM3LinkRelay(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLoF3RP61: writeM3LinkRelay failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -277,12 +331,12 @@ static long write_longout(longoutRecord *precord)
     } else if (device == 'r') { // Shared memory
 #if defined(__powerpc__)
         pacom->pdata = wdata;
-        if (ioctl(f3rp61_fd, M3IO_WRITE_COM, pacom) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_COM, pacom) < 0) {
             errlogPrintf("devLoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #else
-        if (writeM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->writeM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devLoF3RP61: writeM3CpuMemory failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -295,7 +349,7 @@ static long write_longout(longoutRecord *precord)
             pdrly->u.outrly[1].data = wdata[1];
             pdrly->u.outrly[1].mask = mask[1];
         }
-        if (ioctl(f3rp61_fd, M3IO_WRITE_OUTRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_OUTRELAY, pdrly) < 0) {
             errlogPrintf("devLoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -307,34 +361,42 @@ static long write_longout(longoutRecord *precord)
         pdrly->start  = 1;
         pdrly->count  = 3;
         pdrly->u.wdata[0] = wdata[0];
-        if (ioctl(f3rp61_fd, M3IO_WRITE_MODE, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_MODE, pdrly) < 0) {
             errlogPrintf("devLoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #else
-        if (writeM3IoModeRegister(pdrly->unitno, pdrly->slotno, pdrly->start, pdrly->count, wdata) < 0) {
+        if (f3rp61_backend->writeM3IoModeRegister(pdrly->unitno, pdrly->slotno, pdrly->start, pdrly->count, wdata) < 0) {
             errlogPrintf("devLoF3RP61: writeM3IoModeRegisterL failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #endif
 
+    } else if (dpvt->pstage) {  // I/O registers on special modules, staged until committed
+        if (f3rp61_write_stage(dpvt->pstage, pdrly->start, wdata, count) < 0) {
+            errlogPrintf("devLoF3RP61: f3rp61_write_stage failed for %s\n", precord->name);
+            return -1;
+        }
+
     } else {//(device == 'A') // I/O registers on special modules
 
         if (option == 'L') {
             pdrly->u.pldata = ldata;
-            if (ioctl(f3rp61_fd, M3IO_WRITE_REG_L, pdrly) < 0) {
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_REG_L, pdrly) < 0) {
                 errlogPrintf("devLoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
                 return -1;
             }
         } else {
             pdrly->u.pwdata = wdata;
-            if (ioctl(f3rp61_fd, M3IO_WRITE_REG, pdrly) < 0) {
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_REG, pdrly) < 0) {
                 errlogPrintf("devLoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
                 return -1;
             }
         }
     }
 
+    f3rp61_set_last_write(&dpvt->last, wdata, count);
+
     //
     precord->udf = FALSE;
 
@@ -38,6 +38,7 @@
 
 #include <drvF3RP61Seq.h>
 #include <devF3RP61bcd.h>
+#include <devF3RP61conv.h>
 
 // Create the dset for devLoF3RP61Seq
 static long init_record();
@@ -128,7 +129,7 @@ static long init_record(longoutRecord *precord)
     }
 
     // Read the slot number of CPU module
-    if (ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
         errlogPrintf("devLoF3RP61Seq: ioctl failed [%d] for %s\n", errno, precord->name);
         precord->pact = 1;
         return -1;
@@ -138,33 +139,38 @@ static long init_record(longoutRecord *precord)
     F3RP61_SEQ_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_SEQ_DPVT), "calloc failed");
     dpvt->option = option;
 
-    // Compose data structure for I/O request to CPU module
-    MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-    pmcmdStruct->timeOut = 1;
-
-    MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-    pmcmdRequest->formatCode = 0xf1;
-    pmcmdRequest->responseOption = 1;
-    pmcmdRequest->srcSlot = srcSlot;
-    pmcmdRequest->destSlot = destSlot;
-    pmcmdRequest->mainCode = 0x26;
-    pmcmdRequest->subCode = 0x02;
-
-    M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-    pM3WriteSeqdev->accessType = kWord;
+    // Describe the devices accessed by I/O request to CPU module
+    F3RP61_SEQ_ADDR *paddr = &dpvt->addr;
+    paddr->srcSlot = srcSlot;
+    paddr->destSlot = destSlot;
+    paddr->subCode = 0x02; // write
+    paddr->accessType = kWord;
     if (option=='L') {
-        pM3WriteSeqdev->dataNum = 2;
+        paddr->dataNum = 2;
     } else {
-        pM3WriteSeqdev->dataNum = 1;
+        paddr->dataNum = 1;
     }
-    pM3WriteSeqdev->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
-    pM3WriteSeqdev->topDevNo = top;
-    pmcmdRequest->dataSize = 10 + pM3WriteSeqdev->accessType * pM3WriteSeqdev->dataNum;
+    paddr->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
+    paddr->topDevNo = top;
 
     //
     callbackSetUser(precord, &dpvt->callback);
     precord->dpvt = dpvt;
 
+    // Start from the value read back from CPU module at iocInit, except
+    // BCD values which may not be valid
+    uint16_t wData[2] = {0};
+    if (option != 'B' && f3rp61Seq_getReadback(paddr, wData) == 0) {
+        if (option == 'L') {
+            precord->val = (int32_t) devF3RP61words2long(wData);
+        } else if (option == 'U') {
+            precord->val = wData[0];
+        } else {
+            precord->val = (int16_t) wData[0];
+        }
+        precord->udf = FALSE;
+    }
+
     return 0;
 }
 
@@ -181,11 +187,8 @@ static long write_longout(longoutRecord *precord)
             return -1;
         }
 
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_RESPONSE *pmcmdResponse = &pmcmdStruct->mcmdResponse;
-
-        if (pmcmdResponse->errorCode) {
-            errlogPrintf("devLoF3RP61Seq: errorCode 0x%04x returned for %s\n", pmcmdResponse->errorCode, precord->name);
+        if (dpvt->errorCode) {
+            errlogPrintf("devLoF3RP61Seq: errorCode 0x%04x returned for %s\n", dpvt->errorCode, precord->name);
             return -1;
         }
 
@@ -193,10 +196,7 @@ static long write_longout(longoutRecord *precord)
         precord->udf = FALSE;
 
     } else { // First call (PACT is still FALSE)
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-        M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-        uint16_t *wdata = pM3WriteSeqdev->dataBuff.wData;
+        uint16_t *wdata = dpvt->wData;
 
         //
         const char option = dpvt->option;
@@ -204,8 +204,7 @@ static long write_longout(longoutRecord *precord)
             wdata[0] = devF3RP61int2bcd(precord->val, precord);
 
         } else if (option == 'L') {
-            wdata[0] = (uint16_t)(precord->val>> 0);
-            wdata[1] = (uint16_t)(precord->val>>16);
+            devF3RP61long2words(precord->val, wdata);
 
         } else if (option == 'U') {
             wdata[0] = (uint16_t)precord->val;
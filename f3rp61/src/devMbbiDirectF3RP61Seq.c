@@ -80,6 +80,9 @@ static long init_record(mbbiDirectRecord *precord)
     strncpy(buf, plink->value.instio.string, size);
     buf[size - 1] = '\0';
 
+    // Parse cached mode option, read from the image polled in bulk
+    const int cached = f3rp61Seq_parseCachedOption(buf);
+
     // Parse slot, device and register number
     if (sscanf(buf, "CPU%d,%c%d", &destSlot, &device, &top) < 3) {
         errlogPrintf("devMbbiDirectF3RP61Seq: can't get device address for %s\n", precord->name);
@@ -103,7 +106,7 @@ static long init_record(mbbiDirectRecord *precord)
     }
 
     // Read the slot number of CPU module
-    if (ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
         errlogPrintf("devMbbiDirectF3RP61Seq: ioctl failed [%d] for %s\n", errno, precord->name);
         precord->pact = 1;
         return -1;
@@ -112,24 +115,22 @@ static long init_record(mbbiDirectRecord *precord)
     // Allocate private data storage area
     F3RP61_SEQ_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_SEQ_DPVT), "calloc failed");
 
-    // Compose data structure for I/O request to CPU module
-    MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-    pmcmdStruct->timeOut = 1;
-
-    MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-    pmcmdRequest->formatCode = 0xf1;
-    pmcmdRequest->responseOption = 1;
-    pmcmdRequest->srcSlot = srcSlot;
-    pmcmdRequest->destSlot = destSlot;
-    pmcmdRequest->mainCode = 0x26;
-    pmcmdRequest->subCode = 0x01;
-    pmcmdRequest->dataSize = 10;
-
-    M3_READ_SEQDEV *pM3ReadSeqdev = (M3_READ_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-    pM3ReadSeqdev->accessType = kWord;
-    pM3ReadSeqdev->dataNum = 1;
-    pM3ReadSeqdev->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
-    pM3ReadSeqdev->topDevNo = top;
+    // Describe the devices accessed by I/O request to CPU module
+    F3RP61_SEQ_ADDR *paddr = &dpvt->addr;
+    paddr->srcSlot = srcSlot;
+    paddr->destSlot = destSlot;
+    paddr->subCode = 0x01; // read
+    paddr->accessType = kWord;
+    paddr->dataNum = 1;
+    paddr->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
+    paddr->topDevNo = top;
+
+    // Attach to the polled image in the cached mode
+    if (cached && f3rp61Seq_attachPoll(dpvt) < 0) {
+        errlogPrintf("devMbbiDirectF3RP61Seq: no image polled by f3rp61SeqPoll covers %s\n", precord->name);
+        precord->pact = 1;
+        return -1;
+    }
 
     //
     callbackSetUser(precord, &dpvt->callback);
@@ -145,17 +146,19 @@ static long read_mbbiDirect(mbbiDirectRecord *precord)
 {
     F3RP61_SEQ_DPVT *dpvt = precord->dpvt;
 
-    if (precord->pact) { // Second call (PACT is TRUE)
+    // Read the polled image synchronously in the cached mode
+    if (dpvt->ppoll && f3rp61Seq_readPoll((dbCommon *) precord, dpvt) < 0) {
+        return -1;
+    }
+
+    if (precord->pact || dpvt->ppoll) { // Second call (PACT is TRUE), or cached mode
         if (dpvt->ret < 0) {
             errlogPrintf("devMbbiDirectF3RP61Seq: read_mbbiDirect failed for %s\n", precord->name);
             return -1;
         }
 
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_RESPONSE *pmcmdResponse = &pmcmdStruct->mcmdResponse;
-
-        if (pmcmdResponse->errorCode) {
-            errlogPrintf("devMbbiDirectF3RP61Seq: errorCode 0x%04x returned for %s\n", pmcmdResponse->errorCode, precord->name);
+        if (dpvt->errorCode) {
+            errlogPrintf("devMbbiDirectF3RP61Seq: errorCode 0x%04x returned for %s\n", dpvt->errorCode, precord->name);
             return -1;
         }
 
@@ -163,7 +166,7 @@ static long read_mbbiDirect(mbbiDirectRecord *precord)
         precord->udf = FALSE;
 
         // fill VAL field
-        precord->rval = (uint32_t) pmcmdResponse->dataBuff.wData[0];
+        precord->rval = (uint32_t) dpvt->wData[0];
 
     } else { // First call (PACT is still FALSE)
         // Issue read request
@@ -61,11 +61,13 @@ struct {
 epicsExportAddress(dset, devMbbiF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     union {
         M3IO_ACCESS_COM acom;
         M3IO_ACCESS_REG drly;
     } u;
+    F3RP61_SCAN_CACHE_REF cache;
     char device;
 } F3RP61_MBBI_DPVT;
 
@@ -109,6 +111,7 @@ static long init_record(mbbiRecord *precord)
     //}
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':'); // check if SCAN is interrupt based (example: @U0,S3,Y1:U0,S4,X1)
     if (pint) {
         *pint++ = '\0';
@@ -118,7 +121,7 @@ static long init_record(mbbiRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start, &intr) < 0) {
             errlogPrintf("devMbbiF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -144,6 +147,7 @@ static long init_record(mbbiRecord *precord)
 
     // Allocate private data storage area
     F3RP61_MBBI_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_MBBI_DPVT), "calloc failed");
+    dpvt->intr = intr;
     dpvt->device = device;
 
     // Check device validity and compose data structure for I/O request
@@ -166,6 +170,15 @@ static long init_record(mbbiRecord *precord)
         pdrly->start  = start;
         pdrly->count  = 1;
 
+        // Periodically scanned records share a snapshot of registers/relays on the slot
+        if (device == 'A' || device == 'X') {
+            if (f3rp61_register_scan_cache((dbCommon *) precord, &dpvt->cache, device, unitno, slotno, start, 1, 0) < 0) {
+                errlogPrintf("devMbbiF3RP61: can't register scan cache for %s\n", precord->name);
+                precord->pact = 1;
+                return -1;
+            }
+        }
+
     } else {
         errlogPrintf("devMbbiF3RP61: unsupported device \'%c\' for %s\n", device, precord->name);
         precord->pact = 1;
@@ -187,6 +200,9 @@ static long read_mbbi(mbbiRecord *precord)
     M3IO_ACCESS_REG *pdrly = &dpvt->u.drly;
     const char device = dpvt->device;
 
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
     // Buffer for data read
     uint16_t wdata;
 
@@ -194,25 +210,25 @@ static long read_mbbi(mbbiRecord *precord)
     if (0) {                    // dummy
 
     } else if (device == 'R') { // Shared registers
-        if (readM3ComRegister(pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->readM3ComRegister(pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbbiF3RP61: readM3ComRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'W') { // Link registers
-        if (readM3LinkRegister(pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->readM3LinkRegister(pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbbiF3RP61: readM3LinkRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'E') { // Shared relay
-        if (readM3ComRelay(pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->readM3ComRelay(pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbbiF3RP61: readM3ComRelay failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'L') { // Link relay
-        if (readM3LinkRelay(pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->readM3LinkRelay(pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbbiF3RP61: readM3LinkRelay failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -220,26 +236,32 @@ static long read_mbbi(mbbiRecord *precord)
     } else if (device == 'r') { // Shared memory
 #if defined(__powerpc__)
         pacom->pdata = &wdata;
-        if (ioctl(f3rp61_fd, M3IO_READ_COM, pacom) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_COM, pacom) < 0) {
             errlogPrintf("devMbbiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #else
-        if (readM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->readM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbbiF3RP61: readM3CpuMemory failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #endif
 
+    } else if (device == 'X' && dpvt->cache.pcache) { // Input relays on I/O modules, through scan cache
+        if (f3rp61_read_scan_cache((dbCommon *) precord, &dpvt->cache, pdrly->start, 1, &wdata) < 0) {
+            errlogPrintf("devMbbiF3RP61: f3rp61_read_scan_cache failed [%d] for %s\n", errno, precord->name);
+            return -1;
+        }
+
     } else if (device == 'X') { // Input relays on I/O modules
-        if (ioctl(f3rp61_fd, M3IO_READ_INRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_INRELAY, pdrly) < 0) {
             errlogPrintf("devMbbiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
         wdata = pdrly->u.inrly[0].data;
 
     } else if (device == 'Y') { // Output relays on I/O modules
-        if (ioctl(f3rp61_fd, M3IO_READ_OUTRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_OUTRELAY, pdrly) < 0) {
             errlogPrintf("devMbbiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -255,21 +277,27 @@ static long read_mbbi(mbbiRecord *precord)
         // and only the 1st element is valid in the data read out.
         pdrly->start  = 1;
         pdrly->count  = 3;
-        if (ioctl(f3rp61_fd, M3IO_READ_MODE, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_MODE, pdrly) < 0) {
             errlogPrintf("devMbbiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
         wdata = pdrly->u.wdata[0];
 #else
-        if (readM3IoModeRegister(pdrly->unitno, pdrly->slotno, pdrly->start, pdrly->count, &wdata) < 0) {
+        if (f3rp61_backend->readM3IoModeRegister(pdrly->unitno, pdrly->slotno, pdrly->start, pdrly->count, &wdata) < 0) {
             errlogPrintf("devMbbiiF3RP61: readM3IoModeRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #endif
 
+    } else if (dpvt->cache.pcache) { // I/O registers on special modules, through scan cache
+        if (f3rp61_read_scan_cache((dbCommon *) precord, &dpvt->cache, pdrly->start, 1, &wdata) < 0) {
+            errlogPrintf("devMbbiF3RP61: f3rp61_read_scan_cache failed [%d] for %s\n", errno, precord->name);
+            return -1;
+        }
+
     } else {//(device == 'A') // I/O registers on special modules
         pdrly->u.pwdata = &wdata;
-        if (ioctl(f3rp61_fd, M3IO_READ_REG, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG, pdrly) < 0) {
             errlogPrintf("devMbbiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
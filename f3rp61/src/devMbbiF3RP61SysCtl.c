@@ -124,7 +124,7 @@ static long read_mbbi(mbbiRecord *precord)
     if (0) {                                     // dummy
 
     } else if (device == 'S') {                  // Mode-sw
-        if (ioctl(f3rp61SysCtl_fd, M3SC_GET_SW, &data) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61SysCtl_fd, M3SC_GET_SW, &data) < 0) {
             errlogPrintf("devMbbiF3RP61SysCtl: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
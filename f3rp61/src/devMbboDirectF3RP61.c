@@ -61,11 +61,14 @@ struct {
 epicsExportAddress(dset, devMbboDirectF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     union {
         M3IO_ACCESS_COM acom;
         M3IO_ACCESS_REG drly;
     } u;
+    F3RP61_OUT_GROUP_REF group;
+    F3RP61_LAST_WRITE last;
     char device;
 } F3RP61_LO_DPVT;
 
@@ -76,6 +79,7 @@ static long init_record(mbboDirectRecord *precord)
 {
     int unitno = 0, slotno = 0, cpuno = 0, start = 0;
     char device = 0;
+    char option = 0;
 
     // Link type must be INST_IO
     if (precord->out.type != INST_IO) {
@@ -91,24 +95,29 @@ static long init_record(mbboDirectRecord *precord)
     strncpy(buf, plink->value.instio.string, size);
     buf[size - 1] = '\0';
 
+    // Parse option to skip writing unchanged values, which may come along
+    // with another option
+    const int suppress = f3rp61_parse_suppress_option(buf);
+
     // Parse option
-    //char *popt = strchr(buf, '&');
-    //if (popt) {
-    //    char option = 'W'; // Dummy option for Word access
-    //    *popt++ = '\0';
-    //    if (sscanf(popt, "%c", &option) < 1) {
-    //        errlogPrintf("devMbboDirectF3RP61: can't get option for %s\n", precord->name);
-    //        precord->pact = 1;
-    //        return -1;
-    //    }
-    //    if (1) {                    // Option not recognized
-    //        errlogPrintf("devMbboDirectF3RP61: unsupported option \'%c\' for %s\n", option, precord->name);
-    //        precord->pact = 1;
-    //       return -1;
-    //   }
-    //}
+    char *popt = strchr(buf, '&');
+    if (popt) {
+        *popt++ = '\0';
+        if (sscanf(popt, "%c", &option) < 1) {
+            errlogPrintf("devMbboDirectF3RP61: can't get option for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+        if (option == 'G') {        // Write through the output group of the module
+        } else {                    // Option not recognized
+            errlogPrintf("devMbboDirectF3RP61: unsupported option \'%c\' for %s\n", option, precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+    }
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':');
     if (pint) {
         *pint++ = '\0';
@@ -118,7 +127,7 @@ static long init_record(mbboDirectRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start, &intr) < 0) {
             errlogPrintf("devMbboDirectF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -142,8 +151,17 @@ static long init_record(mbboDirectRecord *precord)
         }
     }
 
+    // Only output relays are written through the output group
+    if (option == 'G' && device != 'Y') {
+        errlogPrintf("devMbboDirectF3RP61: option \'%c\' is not supported for device \'%c\' of %s\n", option, device, precord->name);
+        precord->pact = 1;
+        return -1;
+    }
+
     // Allocate private data storage area
     F3RP61_LO_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_LO_DPVT), "calloc failed");
+    dpvt->intr = intr;
+    dpvt->last.enabled = suppress;
     dpvt->device = device;
 
     // Check device validity and compose data structure for I/O request
@@ -166,6 +184,14 @@ static long init_record(mbboDirectRecord *precord)
         pdrly->start  = start;
         pdrly->count  = 1;
 
+        if (option == 'G') {
+            if (f3rp61_register_out_group((dbCommon *) precord, &dpvt->group, unitno, slotno, start) < 0) {
+                errlogPrintf("devMbboDirectF3RP61: can't register output group for %s\n", precord->name);
+                precord->pact = 1;
+                return -1;
+            }
+        }
+
     } else {
         errlogPrintf("devMbboDirectF3RP61: unsupported device \'%c\' for %s\n", device, precord->name);
         precord->pact = 1;
@@ -174,11 +200,22 @@ static long init_record(mbboDirectRecord *precord)
 
     precord->dpvt = dpvt;
 
+    // Start from the value read back from the device at iocInit
+    uint16_t wdata = 0;
+    if ((device == 'R' || device == 'Y' || device == 'A') &&
+        f3rp61_get_readback(device, unitno, slotno, start, 1, &wdata) == 0) {
+        f3rp61_set_last_write(&dpvt->last, &wdata, 1);
+        precord->rval = wdata;
+        return 0; // convert RVAL to VAL
+    }
+
     return 2; // no conversion
 }
 
 // write_mbboDirect() is called when there was a request to process a record.
 // When called, it sends the value from the VAL field to the driver.
+// Writes through the output group complete asynchronously, when the
+// group has been flushed.
 static long write_mbboDirect(mbboDirectRecord *precord)
 {
     F3RP61_LO_DPVT *dpvt = precord->dpvt;
@@ -186,33 +223,56 @@ static long write_mbboDirect(mbboDirectRecord *precord)
     M3IO_ACCESS_REG *pdrly = &dpvt->u.drly;
     const char device = dpvt->device;
 
+    if (precord->pact) { // Second call, after the output group was flushed
+        if (dpvt->group.ret < 0) {
+            errlogPrintf("devMbboDirectF3RP61: output group write failed for %s\n", precord->name);
+            return -1;
+        }
+
+        const uint16_t wdata = (uint16_t) precord->rval;
+        f3rp61_set_last_write(&dpvt->last, &wdata, 1);
+
+        //
+        precord->udf = FALSE;
+
+        return 0;
+    }
+
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
     // Compose data to write
     uint16_t wdata = (uint16_t) precord->rval;
     uint16_t mask  = 0xffff;
 
+    // Skip writing the value last written
+    if (f3rp61_is_write_unchanged(&dpvt->last, &wdata, 1)) {
+        return 0;
+    }
+
     // Issue API function
     if (0) {                    // dummy
 
     } else if (device == 'R') { // Shared registers
-        if (writeM3ComRegister(pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->writeM3ComRegister(pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbboDirectF3RP61: writeM3ComRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'W') { // Link registers
-        if (writeM3LinkRegister(pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->writeM3LinkRegister(pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbboDirectF3RP61: writeM3LinkRegister failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'E') { // Shared relays
-        if (writeM3ComRelay(pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->writeM3ComRelay(pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbboDirectF3RP61: writeM3ComRelay failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 
     } else if (device == 'L') { // Link relays
-        if (writeM3LinkRelay(pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->writeM3LinkRelay(pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbboDirectF3RP61: writeM3LinkRelay failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -220,21 +280,31 @@ static long write_mbboDirect(mbboDirectRecord *precord)
     } else if (device == 'r') { // Shared memory
 #if defined(__powerpc__)
         pacom->pdata = &wdata;
-        if (ioctl(f3rp61_fd, M3IO_WRITE_COM, pacom) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_COM, pacom) < 0) {
             errlogPrintf("devMbboDirectF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #else
-        if (writeM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, &wdata) < 0) {
+        if (f3rp61_backend->writeM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, &wdata) < 0) {
             errlogPrintf("devMbboDirectF3RP61: writeM3CpuMemory failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #endif
 
+    } else if (device == 'Y' && dpvt->group.pgroup) { // Output relays, through the output group
+        if (f3rp61_write_out_group((dbCommon *) precord, &dpvt->group, pdrly->start, wdata, mask) < 0) {
+            errlogPrintf("devMbboDirectF3RP61: f3rp61_write_out_group failed for %s\n", precord->name);
+            return -1;
+        }
+
+        precord->pact = 1;
+
+        return 0;
+
     } else if (device == 'Y') { // Output relays on I/O modules
         pdrly->u.outrly[0].data = wdata;
         pdrly->u.outrly[0].mask = mask;
-        if (ioctl(f3rp61_fd, M3IO_WRITE_OUTRELAY, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_OUTRELAY, pdrly) < 0) {
             errlogPrintf("devMbboDirectF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -246,12 +316,12 @@ static long write_mbboDirect(mbboDirectRecord *precord)
         pdrly->start  = 1;
         pdrly->count  = 3;
         pdrly->u.wdata[0] = wdata;
-        if (ioctl(f3rp61_fd, M3IO_WRITE_MODE, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_MODE, pdrly) < 0) {
             errlogPrintf("devMbboDirectF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
 #else
-        if (writeM3IoModeRegister(pdrly->unitno, pdrly->slotno, pdrly->start, pdrly->count, &wdata) < 0) {
+        if (f3rp61_backend->writeM3IoModeRegister(pdrly->unitno, pdrly->slotno, pdrly->start, pdrly->count, &wdata) < 0) {
             errlogPrintf("devMbboDirectF3RP61: writeM3IoModeRegisterL failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
@@ -259,12 +329,14 @@ static long write_mbboDirect(mbboDirectRecord *precord)
 
     } else {//(device == 'A')   // I/O registers on special modules
         pdrly->u.pwdata = &wdata;
-        if (ioctl(f3rp61_fd, M3IO_WRITE_REG, pdrly) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_REG, pdrly) < 0) {
             errlogPrintf("devMbboDirectF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
             return -1;
         }
     }
 
+    f3rp61_set_last_write(&dpvt->last, &wdata, 1);
+
     //
     precord->udf = FALSE;
 
@@ -103,7 +103,7 @@ static long init_record(mbboDirectRecord *precord)
     }
 
     // Read the slot number of CPU module
-    if (ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
         errlogPrintf("devMbboDirectF3RP61Seq: ioctl failed [%d] for %s\n", errno, precord->name);
         precord->pact = 1;
         return -1;
@@ -112,29 +112,27 @@ static long init_record(mbboDirectRecord *precord)
     // Allocate private data storage area
     F3RP61_SEQ_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_SEQ_DPVT), "calloc failed");
 
-    // Compose data structure for I/O request to CPU module
-    MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-    pmcmdStruct->timeOut = 1;
-
-    MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-    pmcmdRequest->formatCode = 0xf1;
-    pmcmdRequest->responseOption = 1;
-    pmcmdRequest->srcSlot = srcSlot;
-    pmcmdRequest->destSlot = destSlot;
-    pmcmdRequest->mainCode = 0x26;
-    pmcmdRequest->subCode = 0x02;
-    pmcmdRequest->dataSize = 12;
-
-    M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-    pM3WriteSeqdev->accessType = kWord;
-    pM3WriteSeqdev->dataNum = 1;
-    pM3WriteSeqdev->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
-    pM3WriteSeqdev->topDevNo = top;
+    // Describe the devices accessed by I/O request to CPU module
+    F3RP61_SEQ_ADDR *paddr = &dpvt->addr;
+    paddr->srcSlot = srcSlot;
+    paddr->destSlot = destSlot;
+    paddr->subCode = 0x02; // write
+    paddr->accessType = kWord;
+    paddr->dataNum = 1;
+    paddr->devType = device - '@'; // 'D'=>0x04, 'B'=>0x02, 'F'=>0x06, 'Z'=>0x1A, 'I'=>0x09
+    paddr->topDevNo = top;
 
     //
     callbackSetUser(precord, &dpvt->callback);
     precord->dpvt = dpvt;
 
+    // Start from the value read back from CPU module at iocInit
+    uint16_t wData = 0;
+    if (f3rp61Seq_getReadback(paddr, &wData) == 0) {
+        precord->rval = wData;
+        return 0; // convert RVAL to VAL
+    }
+
     return 2; // no conversion
 }
 
@@ -151,11 +149,8 @@ static long write_mbboDirect(mbboDirectRecord *precord)
             return -1;
         }
 
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_RESPONSE *pmcmdResponse = &pmcmdStruct->mcmdResponse;
-
-        if (pmcmdResponse->errorCode) {
-            errlogPrintf("devMbboDirectF3RP61Seq: errorCode 0x%04x returned for %s\n", pmcmdResponse->errorCode, precord->name);
+        if (dpvt->errorCode) {
+            errlogPrintf("devMbboDirectF3RP61Seq: errorCode 0x%04x returned for %s\n", dpvt->errorCode, precord->name);
             return -1;
         }
 
@@ -163,12 +158,8 @@ static long write_mbboDirect(mbboDirectRecord *precord)
         precord->udf = FALSE;
 
     } else { // First call (PACT is still FALSE)
-        MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-        MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-        M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
-
         //
-        pM3WriteSeqdev->dataBuff.wData[0] = (uint16_t) precord->rval;
+        dpvt->wData[0] = (uint16_t) precord->rval;
 
         // Issue write request
         if (f3rp61Seq_queueRequest(dpvt) < 0) {
@@ -60,7 +60,8 @@ struct {
 epicsExportAddress(dset, devSiF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     M3IO_ACCESS_REG drly;
 } F3RP61_SI_DPVT;
 
@@ -87,6 +88,7 @@ static long init_record(stringinRecord *precord)
     buf[size - 1] = '\0';
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':'); // check if SCAN is interrupt based (example: @U0,S3,Y1:U0,S4,X1)
     if (pint) {
         *pint++ = '\0';
@@ -96,7 +98,7 @@ static long init_record(stringinRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start, &intr) < 0) {
             errlogPrintf("devSiF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -112,6 +114,7 @@ static long init_record(stringinRecord *precord)
 
     // Allocate private data storage area
     F3RP61_SI_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_SI_DPVT), "calloc failed");
+    dpvt->intr = intr;
 
     // Check device validity and compose data structure for I/O request
     if (0) {                                     // dummy
@@ -144,8 +147,11 @@ static long read_si(stringinRecord *precord)
     F3RP61_SI_DPVT *dpvt = precord->dpvt;
     M3IO_ACCESS_REG *pdrly = &dpvt->drly;
 
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
     // Issue API function
-    if (ioctl(f3rp61_fd, M3IO_READ_REG, pdrly) < 0) {
+    if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG, pdrly) < 0) {
         errlogPrintf("devSiF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
         return -1;
     }
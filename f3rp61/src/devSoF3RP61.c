@@ -59,7 +59,8 @@ struct {
 epicsExportAddress(dset, devSoF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     M3IO_ACCESS_REG drly;
 } F3RP61_SO_DPVT;
 
@@ -86,6 +87,7 @@ static long init_record(stringoutRecord *precord)
     buf[size - 1] = '\0';
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':');
     if (pint) {
         *pint++ = '\0';
@@ -95,7 +97,7 @@ static long init_record(stringoutRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start, &intr) < 0) {
             errlogPrintf("devSoF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -111,6 +113,7 @@ static long init_record(stringoutRecord *precord)
 
     // Allocate private data storage area
     F3RP61_SO_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_SO_DPVT), "calloc failed");
+    dpvt->intr = intr;
 
     // Check device validity and compose data structure for I/O request
     if (0) {                                     // dummy
@@ -140,10 +143,13 @@ static long write_so(stringoutRecord *precord)
     F3RP61_SO_DPVT *dpvt = precord->dpvt;
     M3IO_ACCESS_REG *pdrly = &dpvt->drly;
 
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
     strncpy((char *) pdrly->u.pbdata, precord->val, 40);
 
     // Issue API function
-    if (ioctl(f3rp61_fd, M3IO_WRITE_REG, pdrly) < 0) {
+    if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_REG, pdrly) < 0) {
         errlogPrintf("devSoF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
         return -1;
     }
@@ -34,6 +34,7 @@
 #include <waveformRecord.h>
 
 #include <drvF3RP61.h>
+#include <devF3RP61conv.h>
 
 // Create the dset for devWfF3RP61
 static long init_record();
@@ -60,14 +61,17 @@ struct {
 epicsExportAddress(dset, devWfF3RP61);
 
 typedef struct {
-    IOSCANPVT ioscanpvt; // must come first
+    IOSCANPVT ioscanpvt; // must come first, as in F3RP61_IO_INTR_DPVT
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
     union {
         M3IO_ACCESS_COM acom;
         M3IO_ACCESS_REG drly;
     } u;
+    F3RP61_SCAN_CACHE_REF cache;
+    uint16_t *wdata; // words read, copied to the record only on success
+    int count;       // number of words
     char device;
     //char option;
-    void *pdata;
 } F3RP61_WF_DPVT;
 
 // init_record() initializes record - parses INP/OUT field string,
@@ -117,6 +121,7 @@ static long init_record(waveformRecord *precord)
     //}
 
     // Parse for possible interrupt source
+    F3RP61_IO_INTR_CHANNEL *intr = NULL;
     char *pint = strchr(buf, ':'); // check if SCAN is interrupt based (example: @U0,S3,Y1:U0,S4,X1)
     if (pint) {
         *pint++ = '\0';
@@ -126,7 +131,7 @@ static long init_record(waveformRecord *precord)
             return -1;
         }
 
-        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start) < 0) {
+        if (f3rp61_register_io_interrupt((dbCommon *) precord, unitno, slotno, start, &intr) < 0) {
             errlogPrintf("devWfF3RP61: can't register I/O interrupt for %s\n", precord->name);
             precord->pact = 1;
             return -1;
@@ -151,11 +156,9 @@ static long init_record(waveformRecord *precord)
 
     // Allocate private data storage area
     F3RP61_WF_DPVT *dpvt = callocMustSucceed(1, sizeof(F3RP61_WF_DPVT), "calloc failed");
+    dpvt->intr = intr;
     dpvt->device = device;
 
-    void *pdata = callocMustSucceed(precord->nelm, dbValueSize(ftvl), "calloc failed");
-    dpvt->pdata = pdata;
-
     // Consider I/O data length
     // Note : It is **WRONG** that count depending on FTVL.
     //        What we need are (1) count depending on &L/&F/&D option and (2) check for supported FTVL.
@@ -190,6 +193,14 @@ static long init_record(waveformRecord *precord)
         pacom->count = count;
 
     } else if (device == 'A') {                  // I/O registers on special modules
+        // Only words and long words are read from the registers, as in
+        // read_wf(), so the others must not get a scan cache
+        if (ftvl != DBF_ULONG && ftvl != DBF_USHORT && ftvl != DBF_SHORT) {
+            errlogPrintf("devWfF3RP61: unsupported FTVL field %d for %s\n", ftvl, precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+
         M3IO_ACCESS_REG *pdrly = &dpvt->u.drly;
         pdrly->unitno = unitno;
         pdrly->slotno = slotno;
@@ -200,12 +211,23 @@ static long init_record(waveformRecord *precord)
             pdrly->count  = count;
         }
 
+        // Periodically scanned records share a snapshot of registers on the slot
+        if (f3rp61_register_scan_cache((dbCommon *) precord, &dpvt->cache, device, unitno, slotno, start, count,
+                                       ftvl == DBF_ULONG) < 0) {
+            errlogPrintf("devWfF3RP61: can't register scan cache for %s\n", precord->name);
+            precord->pact = 1;
+            return -1;
+        }
+
     } else {
         errlogPrintf("devWfF3RP61: unsupported device \'%c\' for %s\n", device, precord->name);
         precord->pact = 1;
         return -1;
     }
 
+    dpvt->wdata = callocMustSucceed(count, sizeof(uint16_t), "calloc failed");
+    dpvt->count = count;
+
     precord->dpvt = dpvt;
 
     return 0;
@@ -223,50 +245,80 @@ static long read_wf(waveformRecord *precord)
     const char device = dpvt->device;
     //const char option = dpvt->option;
 
-    // Buffers for data read
-    uint16_t *wdata = dpvt->pdata;
-    ulong    *ldata = dpvt->pdata;
+    // Time stamp of the interrupt when TSE is -2
+    f3rp61_set_io_interrupt_time((dbCommon *) precord, dpvt->intr);
+
+    // Data are read into a buffer of the same size as that of the record,
+    // so that a failed read leaves the values of the record intact
+    uint16_t *wdata = dpvt->wdata;
 
     // Issue API function
     if (0) {                    // dummy
 
     } else if (device == 'R') { // Shared registers
-        if (readM3ComRegister(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3ComRegister(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devWfF3RP61: readM3ComRegister failed [%d] for %s\n", errno, precord->name);
+            recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
             return -1;
         }
 
     } else if (device == 'W') { // Link registers
-        if (readM3LinkRegister(pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3LinkRegister(pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devWfF3RP61: readM3LinkRegister failed [%d] for %s\n", errno, precord->name);
+            recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
             return -1;
         }
 
     } else if (device == 'r') { // Shared memory
 #if defined(__powerpc__)
         pacom->pdata = wdata;
-        if (ioctl(f3rp61_fd, M3IO_READ_COM, pacom) < 0) {
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_COM, pacom) < 0) {
             errlogPrintf("devWfF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
+            recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
             return -1;
         }
 #else
-        if (readM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, wdata) < 0) {
+        if (f3rp61_backend->readM3CpuMemory(pacom->cpuno, pacom->start, pacom->count, wdata) < 0) {
             errlogPrintf("devWfF3RP61: readM3CpuMemory failed [%d] for %s\n", errno, precord->name);
+            recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
             return -1;
         }
 #endif
 
+    } else if (ftvl != DBF_ULONG && ftvl != DBF_USHORT && ftvl != DBF_SHORT) {
+        errlogPrintf("%s:unsupported field type of value\n", precord->name);
+        precord->pact = 1;
+        return -1;
+
+    } else if (dpvt->cache.pcache) { // I/O registers on special modules, through scan cache
+        const int count = (ftvl == DBF_ULONG) ? pdrly->count*2 : pdrly->count;
+        if (f3rp61_read_scan_cache((dbCommon *) precord, &dpvt->cache, pdrly->start, count, wdata) < 0) {
+            errlogPrintf("devWfF3RP61: f3rp61_read_scan_cache failed [%d] for %s\n", errno, precord->name);
+            recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
+            return -1;
+        }
+
     } else {//(device == 'A')   // I/O registers on special modules
-        if (ftvl != DBF_USHORT && ftvl != DBF_SHORT) {
-            pdrly->u.pldata = ldata;
-            if (ioctl(f3rp61_fd, M3IO_READ_REG_L, pdrly) < 0) {
+        if (ftvl == DBF_ULONG && sizeof(unsigned long) == sizeof(uint32_t)) {
+            pdrly->u.pldata = (unsigned long *) wdata;
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG_L, pdrly) < 0) {
                 errlogPrintf("devWfF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
+                recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
                 return -1;
             }
         } else {
+            // Long words are read as pairs of words on 64-bit hosts, where
+            // unsigned long is wider than the elements of the record
+            const int count = pdrly->count;
+            if (ftvl == DBF_ULONG) {
+                pdrly->count = count*2;
+            }
             pdrly->u.pwdata = wdata;
-            if (ioctl(f3rp61_fd, M3IO_READ_REG, pdrly) < 0) {
+            const int ret = f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG, pdrly);
+            pdrly->count = count;
+            if (ret < 0) {
                 errlogPrintf("devWfF3RP61: ioctl failed [%d] for %s\n", errno, precord->name);
+                recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
                 return -1;
             }
         }
@@ -275,75 +327,33 @@ static long read_wf(waveformRecord *precord)
     //
     precord->udf = FALSE;
 
-    // fill VAL field
-    // need clean up
-    switch (device) {
-        unsigned char  *p1;
-        unsigned long  *p2;
-        unsigned short *p3;
-    case 'r':
-    case 'W':
-    case 'R':
-        switch (ftvl) {
-        case DBF_DOUBLE:
-            p1 = precord->bptr;
-            for (int i = 0; i < precord->nelm; i++) {
-                *p1++ = (wdata[3 + (4 * i)] >> 8) & 0xff; *p1++ = wdata[3 + (4 * i)] & 0xff;
-                *p1++ = (wdata[2 + (4 * i)] >> 8) & 0xff; *p1++ = wdata[2 + (4 * i)] & 0xff;
-                *p1++ = (wdata[1 + (4 * i)] >> 8) & 0xff; *p1++ = wdata[1 + (4 * i)] & 0xff;
-                *p1++ = (wdata[0 + (4 * i)] >> 8) & 0xff; *p1++ = wdata[0 + (4 * i)] & 0xff;
-            }
-            break;
-        case DBF_FLOAT:
-            p1 = precord->bptr;
-            for (int i = 0; i < precord->nelm; i++) {
-                *p1++ = (wdata[1 + (2 * i)] >> 8) & 0xff; *p1++ = wdata[1 + (2 * i)] & 0xff;
-                *p1++ = (wdata[0 + (2 * i)] >> 8) & 0xff; *p1++ = wdata[0 + (2 * i)] & 0xff;
-            }
-            break;
-        case DBF_ULONG:
-        case DBF_LONG:
-            p2 = precord->bptr;
-            for (int i = 0; i < precord->nelm; i++) {
-                p2[i] = ((wdata[1 + (2 *i)] << 16) & 0xffff0000)  |  (wdata[0 + (2 * i)] & 0x0000ffff);
-            }
-            break;
-        case DBF_USHORT:
-        case DBF_SHORT:
-            p3 = precord->bptr;
-            for (int i = 0; i < precord->nelm; i++) {
-                p3[i] = wdata[0 + (1 * i)];
-            }
-            break;
-        default:
-            errlogPrintf("%s:unsupported field type of value\n", precord->name);
-            precord->pact = 1;
-            return -1;
+    // Put the words in order of the elements
+    switch (ftvl) {
+    case DBF_DOUBLE:
+        devF3RP61wordsReverse(wdata, precord->nelm, 4);
+        break;
+    case DBF_FLOAT:
+        devF3RP61wordsReverse(wdata, precord->nelm, 2);
+        break;
+    case DBF_ULONG:
+    case DBF_LONG:
+        // Lower word comes first, as is the case with M3IO_READ_REG_L
+        if (device != 'A' || dpvt->cache.pcache || sizeof(unsigned long) != sizeof(uint32_t)) {
+            devF3RP61wordsJoin(wdata, precord->nelm);
         }
         break;
+    case DBF_USHORT:
+    case DBF_SHORT:
+        break;
     default:
-        switch (ftvl) {
-        case DBF_ULONG:
-            p2 = precord->bptr;
-            for (int i = 0; i < precord->nelm; i++) {
-                p2[i] = ldata[i];
-            }
-            break;
-        case DBF_USHORT:
-        case DBF_SHORT:
-            p3 = precord->bptr;
-            for (int i = 0; i < precord->nelm; i++) {
-                p3[i] = wdata[i];
-            }
-            break;
-        default:
-            errlogPrintf("%s:unsupported field type of value\n", precord->name);
-            precord->pact = 1;
-            return -1;
-        }
+        errlogPrintf("%s:unsupported field type of value\n", precord->name);
+        precord->pact = 1;
+        return -1;
     }
 
+    memcpy(precord->bptr, wdata, dpvt->count * sizeof(uint16_t));
     precord->nord = precord->nelm;
 
     return 0;
 }
+
@@ -0,0 +1,129 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* devWfF3RP61Stat.c - Device Support Routines for F3RP61 Driver
+* Statistics (Waveform)
+*
+*      Date: 2026 Oct. 16
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <alarm.h>
+#include <cantProceed.h>
+#include <dbAccess.h>
+#include <dbDefs.h>
+#include <dbScan.h>
+#include <devSup.h>
+#include <epicsExport.h>
+#include <errlog.h>
+#include <recGbl.h>
+#include <recSup.h>
+#include <waveformRecord.h>
+
+#include <devF3RP61Stat.h>
+
+// Create the dset for devWfF3RP61Stat
+static long init_record();
+static long read_wf();
+
+struct {
+    long       number;
+    DEVSUPFUN  report;
+    DEVSUPFUN  init;
+    DEVSUPFUN  init_record;
+    DEVSUPFUN  get_ioint_info;
+    DEVSUPFUN  read_wf;
+    DEVSUPFUN  special_linconv;
+} devWfF3RP61Stat = {
+    6,
+    NULL,
+    NULL,
+    init_record,
+    NULL,
+    read_wf,
+    NULL
+};
+
+epicsExportAddress(dset, devWfF3RP61Stat);
+
+// init_record() initializes record - parses INP field string and
+// allocates private data storage area.
+static long init_record(waveformRecord *precord)
+{
+    // Link type must be INST_IO
+    if (precord->inp.type != INST_IO) {
+        recGblRecordError(S_db_badField, precord,
+                          "devWfF3RP61Stat (init_record) Illegal INP field");
+        precord->pact = 1;
+        return S_db_badField;
+    }
+
+    // Allocate private data storage area
+    F3RP61_STAT_ADDR *dpvt = callocMustSucceed(1, sizeof(F3RP61_STAT_ADDR), "calloc failed");
+
+    // Parse statistics item
+    if (devF3RP61StatParse(precord->inp.value.instio.string, dpvt) < 0) {
+        errlogPrintf("devWfF3RP61Stat: can't get statistics item for %s\n", precord->name);
+        precord->pact = 1;
+        return -1;
+    }
+
+    if (!devF3RP61StatIsHist(dpvt)) {
+        errlogPrintf("devWfF3RP61Stat: only histogram is supported for %s\n", precord->name);
+        precord->pact = 1;
+        return -1;
+    }
+
+    switch (precord->ftvl) {
+    case DBF_DOUBLE:
+    case DBF_ULONG:
+    case DBF_LONG:
+        break;
+    default:
+        errlogPrintf("devWfF3RP61Stat: unsupported FTVL field %d for %s\n", precord->ftvl, precord->name);
+        precord->pact = 1;
+        return -1;
+    }
+
+    precord->dpvt = dpvt;
+
+    return 0;
+}
+
+// read_wf() is called when there was a request to process a record.
+// When called, it reads the histogram from the driver and stores to the
+// VAL field.
+static long read_wf(waveformRecord *precord)
+{
+    F3RP61_STAT_ADDR *dpvt = precord->dpvt;
+    unsigned long hist[F3RP61_LATENCY_NBINS];
+
+    if (devF3RP61StatGetHist(dpvt, hist) < 0) {
+        recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
+        return -1;
+    }
+
+    const int nelm = (precord->nelm < F3RP61_LATENCY_NBINS) ? precord->nelm : F3RP61_LATENCY_NBINS;
+    for (int i = 0; i < nelm; i++) {
+        switch (precord->ftvl) {
+        case DBF_DOUBLE:
+            ((double *) precord->bptr)[i] = hist[i];
+            break;
+        case DBF_ULONG:
+        case DBF_LONG:
+            ((epicsUInt32 *) precord->bptr)[i] = hist[i];
+            break;
+        }
+    }
+
+    precord->nord = nelm;
+    precord->udf  = FALSE;
+
+    return 0;
+}
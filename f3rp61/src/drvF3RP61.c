@@ -14,6 +14,9 @@
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <math.h>
+#include <sched.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,18 +24,30 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/msg.h>
+#include <time.h>
 #include <unistd.h>
 
+#include <callback.h>
+#include <cantProceed.h>
+#include <dbAccess.h>
+#include <dbDefs.h>
 #include <dbCommon.h>
 #include <dbScan.h>
+#include <dbStaticLib.h>
 #include <drvSup.h>
+#include <ellLib.h>
+#include <epicsAtomic.h>
 #include <epicsExport.h>
+#include <epicsMutex.h>
 #include <epicsThread.h>
+#include <epicsTime.h>
+#include <epicsVersion.h>
 #include <errlog.h>
 #include <iocsh.h>
 #include <recSup.h>
 
 #include <drvF3RP61.h>
+#include <devF3RP61conv.h>
 
 //
 #define M3IO_NUM_CPUS   4
@@ -40,30 +55,221 @@
 // A single F3RP61/71 module can work with up to two FL-net interface modules.
 #define M3IO_NUM_LINKS  2
 
+// Interrupt dispatch table
 //
-#define NUM_IO_INTR  8
+// Records are attached to interrupt channels of (unit, slot), and the
+// channel of an incoming message is looked up by indexing. Both the
+// table of channels and the list of records on a channel grow on
+// demand, so that any number of records can be attached to a channel.
+// The records on a channel share a single IOSCANPVT so that one
+// interrupt results in one scanIoRequest(). The time of the latest
+// interrupt is captured upon receipt of the message, and is given to
+// the records with TSE of -2 (device time).
+//
+// Each channel also keeps statistics of the interrupts. The latency is
+// measured on the monotonic clock from receipt of the message to
+// scanIoRequest(), and to completion of the records where the EPICS
+// base supports completion callbacks of I/O scan lists.
+struct F3RP61_IO_INTR_CHANNEL {
+    IOSCANPVT ioscanpvt;
+    epicsMutexId mutex; // mutex of the slot
+    epicsTimeStamp time;
+    struct timespec received_at;
+    unsigned int pending; // callback priorities not completed yet
+    int enabled;          // M3IO_ENABLE_INTER succeeded
+    F3RP61_IO_INTR_STAT stat;
+    dbCommon **precs;
+    int nrecs;
+    int size;
+};
 
 typedef struct {
-    int channel;
-    dbCommon *prec;
-} F3RP61_IO_SCAN;
+    epicsMutexId mutex;
+    int msqid;
+    F3RP61_IO_INTR_CHANNEL **channels; // indexed by channel number
+    int nchannels;
+} F3RP61_IO_INTR;
+
+#ifndef epicsTimeEventDeviceTime
+#define epicsTimeEventDeviceTime -2
+#endif
+
+#if defined(VERSION_INT) && EPICS_VERSION_INT >= VERSION_INT(3, 16, 1, 0)
+#define HAS_IO_SCAN_COMPLETE
+#endif
+
+static F3RP61_IO_INTR io_intr[M3IO_NUM_UNIT][M3IO_NUM_SLOT + 1]; // slot number starts from 1
+
+// Interrupt receivers
+//
+// By default, a message queue and a receiver thread are created for each
+// slot with interrupt sources. With f3rp61InterruptConfigure, the slots
+// are distributed over a fixed number of shared queues served by a fixed
+// pool of receiver threads.
+static int intr_num_queues  = 0; // 0 for a queue per slot
+static int intr_num_threads = 0;
+static int intr_priority    = epicsThreadPriorityHigh;
+static int intr_cpu_mask    = 0; // 0 for no CPU affinity
+static int *intr_msqids;         // shared queues
+static int intr_started;         // set once the first receiver is started
+
+// Errors which can't be attributed to any channel
+static epicsMutexId intr_stat_mutex;
+static unsigned long intr_errors;
+static unsigned long intr_unmatched;
+
+// Maximum number of words read by a single scan cache transaction
+#define SCAN_CACHE_MAX_COUNT        256 // I/O registers (A)
+#define SCAN_CACHE_MAX_RELAY_COUNT  4   // Input relays (X), 64 relays in 4 words
+
+// Records on the same (unit, slot) scanned periodically at the same rate
+// share a single snapshot of the union of their register (or relay word)
+// ranges. The first record processed in a scan pass refreshes the
+// snapshot with one ioctl() and the rest of the records just pick their
+// words out of it. Registers of records reading long words (&L, &F, &D
+// and FTVL of ULONG) go to snapshots of their own, refreshed with
+// M3IO_READ_REG_L as the records read them directly, so that the module
+// latches each pair of registers as it does for those records.
+struct F3RP61_SCAN_CACHE {
+    ELLNODE node;
+    epicsMutexId mutex;
+    char device;
+    int longword; // registers read in pairs with M3IO_READ_REG_L
+    int unitno;
+    int slotno;
+    int scan;
+    int start; // index of the first word, see word_index()
+    int count; // number of words
+    uint16_t *wdata;
+    unsigned int generation;
+    int valid;
+};
+
+static ELLLIST scan_cache_list;
+static int scan_cache_enable = 1;
+
+// Maximum number of words written by a single output group transaction
+#define OUT_GROUP_MAX_RELAY_COUNT   4   // Output relays (Y), 64 relays in 4 words
+
+// Writes of the records on output relays of the same (unit, slot) with
+// the &G option are accumulated in a shadow of the relay words, along
+// with the mask of the relays changed, and written all at once with one
+// masked ioctl(), which completes the records processed asynchronously.
+//
+// A group with a flush record is written only when the flush record is
+// processed, e.g. at the end of a fanout, so the relays written before
+// it switch together. Otherwise the first write schedules a flush on
+// the low priority callback thread, which is best-effort: on a multi-
+// core CPU the flush may run before the scan thread is done with the
+// rest of the records of the pass, which then go into the next flush.
+struct F3RP61_OUT_GROUP {
+    ELLNODE node;
+    epicsMutexId mutex;
+    int unitno;
+    int slotno;
+    uint16_t data[OUT_GROUP_MAX_RELAY_COUNT];
+    uint16_t mask[OUT_GROUP_MAX_RELAY_COUNT]; // relays changed since the last flush
+    ELLLIST pending; // records waiting for the flush
+    CALLBACK callback;
+    int scheduled;
+    int flush_record;      // flushed only by the flush record
+    unsigned long writes;  // writes of the records
+    unsigned long flushes; // ioctl() issued
+};
+
+static ELLLIST out_group_list;
+static double out_group_delay = 0.0; // seconds before the flush
+
+// Output records with the &S option skip writing the value last written
+// successfully, unless it was written more than write_refresh seconds
+// ago (0 for never)
+static double write_refresh = 0.0;
+static size_t write_suppressed; // writes skipped
+static size_t write_issued;     // writes of the records with the &S option
+
+// Maximum number of I/O registers (A) written by a single commit
+#define STAGE_MAX_COUNT             256
+
+// Output records on I/O registers (A) of the same (unit, slot) with the
+// &T option stage their words in the staging area of the module instead
+// of writing them. A commit record writes the words staged since the
+// last commit all at once, one ioctl() for each run of contiguous
+// registers, so that the module never sees a half-updated set of
+// parameters. Registers which are not staged are never written.
+struct F3RP61_STAGE {
+    ELLNODE node;
+    epicsMutexId mutex;
+    int unitno;
+    int slotno;
+    int start; // first register covered by the records
+    int count; // number of registers
+    uint16_t *wdata;
+    uint8_t *dirty; // registers staged since the last commit
+    unsigned long writes;  // writes of the records
+    unsigned long commits; // commits with registers staged
+};
+
+static ELLLIST stage_list;
 
+// Maximum number of words read back by a single transaction
+#define READBACK_MAX_COUNT          256 // I/O registers (A) and shared registers (R)
+#define READBACK_MAX_RELAY_COUNT    4   // Output relays (Y), 64 relays in 4 words
+
+// With readback enabled, the devices written by the output records are
+// read at iocInit, before the records are initialized, so that the
+// records start from the values on the hardware and do not bump the
+// outputs. The output records are found in the database, and the union
+// of the ranges written on the same (unit, slot) is read at once as far
+// as it fits into a single transaction.
 typedef struct {
-    F3RP61_IO_SCAN ioscan[NUM_IO_INTR];
-    int count;
-} F3RP61_IO_INTR;
+    ELLNODE node;
+    char device;
+    int unitno;
+    int slotno;
+    int start; // index of the first word, see word_index()
+    int count; // number of words
+    uint16_t *wdata;
+    int valid;
+} F3RP61_READBACK;
+
+static ELLLIST readback_list;
+static int readback_enable = 0;
+
+// ao records on I/O registers (A) or shared registers (R) with the &R
+// option hand their target to a ramp instead of writing it. The ramp
+// thread moves the value of each ramp towards its target at the rate of
+// the record, and writes the value every ramp_period seconds until the
+// target is reached, without processing the record. The value is the
+// raw value (RVAL) written, or VAL with the &F and &D options.
+struct F3RP61_RAMP {
+    ELLNODE node;
+    dbCommon *prec;
+    char device;
+    char option;
+    int unitno;
+    int slotno;
+    int start;
+    double rate;    // per second
+    double value;   // last written
+    double target;
+    int valid;      // value is known
+    int active;     // moving towards the target
+    int failing;    // last write failed
+    unsigned long writes;
+    unsigned long errors;
+};
 
-static F3RP61_IO_INTR io_intr[M3IO_NUM_UNIT][M3IO_NUM_SLOT];
+static ELLLIST ramp_list;
+static epicsMutexId ramp_mutex;
+static double ramp_period = 0.01; // seconds between writes
 
 //
 typedef struct {
     long mtype;
-#if defined(__arm__)
-    M3IO_MSG_IO mtext;
-#elif defined(__powerpc__)
+#if defined(__powerpc__)
     M3IO_IO_EVENT mtext;
 #else
-#  error
+    M3IO_MSG_IO mtext;
 #endif
 } MSG_BUF;
 
@@ -87,20 +293,110 @@ int f3rp61_fd = -1;
 
 //
 static void msgrcv_thread(void *);
+static int create_msg_queue(void);
+static int get_msg_queue(int, int);
+static double elapsed_usec(const struct timespec *, const struct timespec *);
+static void latency_print(const char *, const F3RP61_LATENCY *, int);
+#if defined(HAS_IO_SCAN_COMPLETE)
+static void io_intr_complete(void *, IOSCANPVT, int);
+#endif
+static int word_index(char, int);
+static int word_start(char, int);
 static M3LINKDATACONFIG link_data_config;
 static M3COMDATACONFIG com_data_config;
 static M3COMDATACONFIG ext_com_data_config;
 static void linkDeviceConfigureCallFunc(const iocshArgBuf *);
 static void comDeviceConfigureCallFunc(const iocshArgBuf *);
 static void getModuleInfoCallFunc(const iocshArgBuf *);
+static void scanCacheConfigureCallFunc(const iocshArgBuf *);
+static void outGroupConfigureCallFunc(const iocshArgBuf *);
+static void writeSuppressConfigureCallFunc(const iocshArgBuf *);
+static void readbackConfigureCallFunc(const iocshArgBuf *);
+static void rampConfigureCallFunc(const iocshArgBuf *);
+static void interruptConfigureCallFunc(const iocshArgBuf *);
+static void interruptStatsCallFunc(const iocshArgBuf *);
+static void interruptStatsResetCallFunc(const iocshArgBuf *);
 static void linkDeviceConfigure(int, int, int);
 static void comDeviceConfigure(int, int, int, int, int);
 static void getModuleInfo(int);
+static void scanCacheConfigure(int);
+static void outGroupConfigure(double);
+static void writeSuppressConfigure(double);
+static void readbackConfigure(int);
+static void rampConfigure(double);
+static void ramp_thread(void *);
+static int write_ramp_value(const F3RP61_RAMP *, double);
+static int module_relay_words(int, int);
+static void add_readback(char, int, int, int, int);
+static void find_readback(const char *, const char *, void *);
+static void take_readbacks(void);
+static F3RP61_OUT_GROUP *get_out_group(int, int);
+static int write_out_group(F3RP61_OUT_GROUP *);
+static void flush_out_group(CALLBACK *);
+static void interruptConfigure(int, int, int, int);
+static void interruptStats(int);
+static void interruptStatsReset(void);
 static void drvF3RP61RegisterCommands(void);
+static int strip_option(char *, const char *);
 
 //
-static long report(void)
+static long report(int level)
 {
+    if (level < 1) {
+        return 0;
+    }
+
+    printf("Backend: %s\n", f3rp61_backend->name);
+    printf("Scan cache: %s\n", scan_cache_enable ? "enabled" : "disabled");
+    for (F3RP61_SCAN_CACHE *pcache = (F3RP61_SCAN_CACHE *) ellFirst(&scan_cache_list);
+         pcache;
+         pcache = (F3RP61_SCAN_CACHE *) ellNext(&pcache->node)) {
+        printf("  U%d,S%d,%c%d (%d words) scan=%d generation=%u\n",
+               pcache->unitno, pcache->slotno, pcache->device,
+               word_start(pcache->device, pcache->start), pcache->count,
+               pcache->scan, pcache->generation);
+    }
+    printf("Output groups: flushed %.3f s after the first write\n", out_group_delay);
+    for (F3RP61_OUT_GROUP *pgroup = (F3RP61_OUT_GROUP *) ellFirst(&out_group_list);
+         pgroup;
+         pgroup = (F3RP61_OUT_GROUP *) ellNext(&pgroup->node)) {
+        printf("  U%d,S%d,Y writes=%lu flushes=%lu%s\n",
+               pgroup->unitno, pgroup->slotno, pgroup->writes, pgroup->flushes,
+               pgroup->flush_record ? " (by flush record)" : "");
+    }
+    printf("Write suppression: %lu of %lu writes skipped, refreshed every %.3f s\n",
+           (unsigned long) epicsAtomicGetSizeT(&write_suppressed),
+           (unsigned long) (epicsAtomicGetSizeT(&write_suppressed) + epicsAtomicGetSizeT(&write_issued)),
+           write_refresh);
+    printf("Readback: %s\n", readback_enable ? "enabled" : "disabled");
+    for (F3RP61_READBACK *preadback = (F3RP61_READBACK *) ellFirst(&readback_list);
+         preadback;
+         preadback = (F3RP61_READBACK *) ellNext(&preadback->node)) {
+        printf("  U%d,S%d,%c%d (%d words) %s\n",
+               preadback->unitno, preadback->slotno, preadback->device,
+               word_start(preadback->device, preadback->start), preadback->count,
+               preadback->valid ? "read" : "not read");
+    }
+    printf("Ramps: written every %.3f s\n", ramp_period);
+    if (ramp_mutex) {
+        epicsMutexMustLock(ramp_mutex);
+        for (F3RP61_RAMP *pramp = (F3RP61_RAMP *) ellFirst(&ramp_list);
+             pramp;
+             pramp = (F3RP61_RAMP *) ellNext(&pramp->node)) {
+            printf("  %s: %g -> %g at %g/s %s, %lu writes, %lu errors\n",
+                   pramp->prec->name, pramp->value, pramp->target, pramp->rate,
+                   pramp->active ? "ramping" : "idle", pramp->writes, pramp->errors);
+        }
+        epicsMutexUnlock(ramp_mutex);
+    }
+    for (F3RP61_STAGE *pstage = (F3RP61_STAGE *) ellFirst(&stage_list);
+         pstage;
+         pstage = (F3RP61_STAGE *) ellNext(&pstage->node)) {
+        printf("  U%d,S%d,A%d (%d words) staged writes=%lu commits=%lu\n",
+               pstage->unitno, pstage->slotno, pstage->start, pstage->count,
+               pstage->writes, pstage->commits);
+    }
+
     return 0;
 }
 
@@ -113,7 +409,7 @@ static long init(void)
     }
     init_flag = 1;
 
-    f3rp61_fd = open("/dev/m3io", O_RDWR);
+    f3rp61_fd = f3rp61_backend->open("/dev/m3io", O_RDWR);
     if (f3rp61_fd < 0) {
         errlogPrintf("drvF3RP61: can't open /dev/m3io [%d] : %s\n", errno, strerror(errno));
         return -1;
@@ -123,7 +419,7 @@ static long init(void)
         if (com_data_config.wNumberOfRelay[i] || com_data_config.wNumberOfRegister[i] ||
             ext_com_data_config.wNumberOfRelay[i] || ext_com_data_config.wNumberOfRegister[i]) {
 
-            if (setM3ComDataConfig(&com_data_config, &ext_com_data_config) < 0) {
+            if (f3rp61_backend->setM3ComDataConfig(&com_data_config, &ext_com_data_config) < 0) {
                 errlogPrintf("drvF3RP61: setM3ComDataConfig failed [%d]\n", errno);
                 return -1;
             }
@@ -132,153 +428,1550 @@ static long init(void)
         }
     }
 
-    for (int i = 0; i < M3IO_NUM_LINKS; i++) {
-        if (link_data_config.wNumberOfRelay[i] || link_data_config.wNumberOfRegister[i]) {
+    for (int i = 0; i < M3IO_NUM_LINKS; i++) {
+        if (link_data_config.wNumberOfRelay[i] || link_data_config.wNumberOfRegister[i]) {
+
+            if (f3rp61_backend->setM3LinkDeviceConfig(&link_data_config) < 0) {
+                errlogPrintf("drvF3RP61: setM3LinkDeviceConfig failed [%d]\n", errno);
+                return -1;
+            }
+
+            if (f3rp61_backend->setM3FlnSysNo(0, NULL) < 0) {
+                errlogPrintf("drvF3RP61: setM3FlnSysNo failed [%d]\n", errno);
+                // 414 (invalid number)  : invalid parameter was specified (F3RP71/61)
+                // 415 (device mismatch) : specified modules is not FL-net (F3RP71)
+                // 416 (number over)     : an excessive number of system is specified (F3RP71)
+                // 417 (entry error)     : unable to access module or I/O bus error (F3RP71)
+                // 397 (internal error)  : (F3RP61)
+                // 394                   : Not documented in the manual; setM3FlnSysNo() was called after m3rfrsTsk(). We'd better to reset the CPU.
+                return -1;
+            }
+
+            if (f3rp61_backend->m3rfrsTsk(10) < 0) {
+                errlogPrintf("drvF3RP61: m3rfrsTsk failed [%d]\n", errno);
+                return -1;
+            }
+
+            break;
+        }
+
+    }
+
+    if (readback_enable) {
+        f3rp61_for_each_output("F3RP61", find_readback, NULL);
+        take_readbacks();
+    }
+
+    return 0;
+}
+
+//
+static void msgrcv_thread(void *arg)
+{
+    int msqid = (int) (intptr_t) arg;
+
+    if (intr_cpu_mask) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for (int cpu = 0; cpu < 8 * (int) sizeof(intr_cpu_mask); cpu++) {
+            if (intr_cpu_mask & (1u << cpu)) {
+                CPU_SET(cpu, &cpuset);
+            }
+        }
+        if (sched_setaffinity(0, sizeof(cpuset), &cpuset) < 0) {
+            errlogPrintf("drvF3RP61: sched_setaffinity failed [%d] : %s\n", errno, strerror(errno));
+        }
+    }
+
+    for (;;) {
+        MSG_BUF msgbuf;
+        const ssize_t val = msgrcv(msqid, &msgbuf, sizeof(MSG_BUF), M3IO_MSGTYPE_IO, MSG_NOERROR);
+
+        // Capture the time of the interrupt as early as possible
+        struct timespec ts, received_at;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        clock_gettime(CLOCK_MONOTONIC, &received_at);
+
+        if (val == -1 && (errno == EIDRM || errno == EINVAL)) {
+            // The queue has been removed as the receivers failed to start
+            return;
+        }
+
+        if (val == -1) {
+            errlogPrintf("drvF3RP61: msgrcv failed [%d] : %s\n", errno, strerror(errno));
+            epicsMutexMustLock(intr_stat_mutex);
+            intr_errors++;
+            epicsMutexUnlock(intr_stat_mutex);
+            // msgbuf might be uninitialized if msgrcv() failed.
+            continue;
+        }
+
+        if (val < 16) {
+            // for just in case
+            errlogPrintf("drvF3RP61: message received by msgrcv() is too small (%d bytes)\n", (int) val);
+            epicsMutexMustLock(intr_stat_mutex);
+            intr_errors++;
+            epicsMutexUnlock(intr_stat_mutex);
+            continue;
+        }
+
+        const int unit    = msgbuf.mtext.unit;
+        const int slot    = msgbuf.mtext.slot;
+        const int channel = msgbuf.mtext.channel;
+
+        F3RP61_IO_INTR *pintr = NULL;
+        if (unit >= 0 && unit < M3IO_NUM_UNIT && slot >= 1 && slot <= M3IO_NUM_SLOT) {
+            pintr = &io_intr[unit][slot];
+        } else {
+            errlogPrintf("drvF3RP61: interrupt from unknown module (U%d,S%d,C%d)\n", unit, slot, channel);
+        }
+
+        F3RP61_IO_INTR_CHANNEL *pchannel = NULL;
+        if (pintr && pintr->mutex) {
+            epicsMutexMustLock(pintr->mutex);
+            if (channel >= 0 && channel < pintr->nchannels) {
+                pchannel = pintr->channels[channel];
+            }
+            if (!pchannel) {
+                epicsMutexUnlock(pintr->mutex);
+            }
+        }
+
+        if (!pchannel) {
+            epicsMutexMustLock(intr_stat_mutex);
+            intr_unmatched++;
+            epicsMutexUnlock(intr_stat_mutex);
+            continue;
+        }
+
+        // The slot mutex is held from here
+        pchannel->stat.received++;
+
+        // With more threads than queues, a message may be handled after
+        // a later one of the channel taken by another thread. The later
+        // interrupt has requested the records already, so the message
+        // only counts as an overrun and the time never goes backwards.
+        if (elapsed_usec(&pchannel->received_at, &received_at) < 0) {
+            pchannel->stat.overruns++;
+            epicsMutexUnlock(pintr->mutex);
+            continue;
+        }
+
+        epicsTimeFromTimespec(&pchannel->time, &ts);
+        pchannel->received_at = received_at;
+        if (pchannel->pending) {
+            pchannel->stat.overruns++;
+        }
+
+        // Request under the mutex so that completion of the records is
+        // never handled before the request is accounted
+#if defined(HAS_IO_SCAN_COMPLETE)
+        pchannel->pending |= scanIoRequest(pchannel->ioscanpvt);
+#else
+        scanIoRequest(pchannel->ioscanpvt);
+#endif
+
+        struct timespec requested_at;
+        clock_gettime(CLOCK_MONOTONIC, &requested_at);
+        f3rp61_latency_add(&pchannel->stat.request, elapsed_usec(&received_at, &requested_at));
+
+        epicsMutexUnlock(pintr->mutex);
+    }
+}
+
+#if defined(HAS_IO_SCAN_COMPLETE)
+//////////////////////////////////////////////////////////////////////////
+//
+// Called when all the records of an interrupt channel on a callback
+// priority have been processed
+//
+static void io_intr_complete(void *usr, IOSCANPVT ioscanpvt, int prio)
+{
+    F3RP61_IO_INTR_CHANNEL *pchannel = usr;
+    struct timespec completed_at;
+    clock_gettime(CLOCK_MONOTONIC, &completed_at);
+
+    epicsMutexMustLock(pchannel->mutex);
+    if (pchannel->pending & (1 << prio)) {
+        pchannel->pending &= ~(1 << prio);
+        if (!pchannel->pending) {
+            f3rp61_latency_add(&pchannel->stat.complete,
+                               elapsed_usec(&pchannel->received_at, &completed_at));
+        }
+    }
+    epicsMutexUnlock(pchannel->mutex);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Create a SysV message queue
+//
+static int create_msg_queue(void)
+{
+    int msqid = msgget(IPC_PRIVATE, IPC_CREAT | 0666);
+    if (msqid  == -1) {
+        errlogPrintf("drvF3RP61: msgget failed [%d] : %s\n", errno, strerror(errno));
+        return -1;
+    }
+
+#if defined(__powerpc__)
+    if (msqid == 0) {
+        // Get another message queue ID when it's 0.
+        // Message queue id 0 is valid in SysV IPC but invalid in F3RP61 BSP.
+        msqid = msgget(IPC_PRIVATE, IPC_CREAT | 0666);
+        if (msqid == -1) {
+            errlogPrintf("drvF3RP61: msgget failed [%d] : %s\n", errno, strerror(errno));
+            return -1;
+        }
+    }
+#endif
+
+    return msqid;
+}
+
+// Remove a message queue, waking up its receivers to return
+static void remove_msg_queue(int msqid)
+{
+    if (msgctl(msqid, IPC_RMID, NULL) == -1) {
+        errlogPrintf("drvF3RP61: msgctl failed [%d] : %s\n", errno, strerror(errno));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Get the message queue for interrupts of (unit, slot), creating the
+// queue(s) and the receiver thread(s) on demand
+//
+static int get_msg_queue(int unit, int slot)
+{
+    char thread_name[32];
+
+    intr_started = 1;
+    if (!intr_stat_mutex) {
+        intr_stat_mutex = epicsMutexMustCreate();
+    }
+
+    // A queue and a thread dedicated to the slot
+    if (intr_num_queues == 0) {
+        const int msqid = create_msg_queue();
+        if (msqid == -1) {
+            return -1;
+        }
+
+        sprintf(thread_name, "msgrcvr%d", msqid);
+        if (epicsThreadCreate(thread_name,
+                              intr_priority,
+                              epicsThreadGetStackSize(epicsThreadStackSmall),
+                              (EPICSTHREADFUNC) msgrcv_thread,
+                              (void *) (intptr_t) msqid) == 0) {
+            errlogPrintf("drvF3RP61: epicsThreadCreate failed\n");
+            remove_msg_queue(msqid);
+            return -1;
+        }
+
+        return msqid;
+    }
+
+    // Queues shared by the slots and the pool of threads serving them.
+    // Should any of them fail, all the queues are removed, so that the
+    // threads started return, and the next slot tries again.
+    if (!intr_msqids) {
+        int *msqids = callocMustSucceed(intr_num_queues, sizeof(int), "calloc failed");
+        int nqueues = 0;
+        while (nqueues < intr_num_queues) {
+            msqids[nqueues] = create_msg_queue();
+            if (msqids[nqueues] == -1) {
+                break;
+            }
+            nqueues++;
+        }
+
+        int nthreads = 0;
+        while (nqueues == intr_num_queues && nthreads < intr_num_threads) {
+            const int msqid = msqids[nthreads % intr_num_queues];
+            sprintf(thread_name, "msgrcvr%d_%d", msqid, nthreads / intr_num_queues);
+            if (epicsThreadCreate(thread_name,
+                                  intr_priority,
+                                  epicsThreadGetStackSize(epicsThreadStackSmall),
+                                  (EPICSTHREADFUNC) msgrcv_thread,
+                                  (void *) (intptr_t) msqid) == 0) {
+                errlogPrintf("drvF3RP61: epicsThreadCreate failed\n");
+                break;
+            }
+            nthreads++;
+        }
+
+        if (nthreads < intr_num_threads) {
+            for (int i = 0; i < nqueues; i++) {
+                remove_msg_queue(msqids[i]);
+            }
+            free(msqids);
+            return -1;
+        }
+
+        intr_msqids = msqids;
+    }
+
+    return intr_msqids[(unit * M3IO_NUM_SLOT + slot - 1) % intr_num_queues];
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+long f3rp61_register_io_interrupt(dbCommon *prec, int unit, int slot, int channel, F3RP61_IO_INTR_CHANNEL **ppchannel)
+{
+    if (unit < 0 || unit >= M3IO_NUM_UNIT || slot < 1 || slot > M3IO_NUM_SLOT || channel < 1) {
+        errlogPrintf("drvF3RP61: interrupt source (U%d,S%d,X%d) out of range\n", unit, slot, channel);
+        return -1;
+    }
+
+    F3RP61_IO_INTR *pintr = &io_intr[unit][slot];
+
+    // Get a SysV message queue served by a thread which reveices the message
+    if (!pintr->mutex) {
+        const int msqid = get_msg_queue(unit, slot);
+        if (msqid == -1) {
+            return -1;
+        }
+
+        pintr->mutex = epicsMutexMustCreate();
+        pintr->msqid = msqid;
+    }
+
+    epicsMutexMustLock(pintr->mutex);
+
+    // Grow the table of channels
+    if (channel >= pintr->nchannels) {
+        const int nchannels = channel + 1;
+        pintr->channels = realloc(pintr->channels, nchannels * sizeof(F3RP61_IO_INTR_CHANNEL *));
+        if (!pintr->channels) {
+            cantProceed("drvF3RP61: realloc failed\n");
+        }
+        memset(&pintr->channels[pintr->nchannels], 0,
+               (nchannels - pintr->nchannels) * sizeof(F3RP61_IO_INTR_CHANNEL *));
+        pintr->nchannels = nchannels;
+    }
+
+    // Channels are allocated individually so that records can keep
+    // pointers to them
+    if (!pintr->channels[channel]) {
+        pintr->channels[channel] = callocMustSucceed(1, sizeof(F3RP61_IO_INTR_CHANNEL), "calloc failed");
+        pintr->channels[channel]->mutex = pintr->mutex;
+    }
+
+    // Grow the list of records on the channel
+    F3RP61_IO_INTR_CHANNEL *pchannel = pintr->channels[channel];
+    if (pchannel->nrecs == pchannel->size) {
+        pchannel->size = pchannel->size ? pchannel->size * 2 : 4;
+        pchannel->precs = realloc(pchannel->precs, pchannel->size * sizeof(dbCommon *));
+        if (!pchannel->precs) {
+            cantProceed("drvF3RP61: realloc failed\n");
+        }
+    }
+    if (!pchannel->ioscanpvt) {
+        scanIoInit(&pchannel->ioscanpvt);
+#if defined(HAS_IO_SCAN_COMPLETE)
+        scanIoSetComplete(pchannel->ioscanpvt, io_intr_complete, pchannel);
+#endif
+    }
+
+    // Enable the interrupt with the first record, or with the next one
+    // if it failed for the records before
+    if (!pchannel->enabled) {
+        M3IO_INTER_DEFINE arg = {
+            .unitno = unit,
+            .slotno = slot,
+            .defData.relayNo = channel,
+            .msgQId = pintr->msqid,
+        };
+
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_ENABLE_INTER, &arg) < 0) {
+            errlogPrintf("drvF3RP61: ioctl failed [%d]\n", errno);
+            epicsMutexUnlock(pintr->mutex);
+            return -1;
+        }
+        pchannel->enabled = 1;
+    }
+
+    pchannel->precs[pchannel->nrecs++] = prec;
+
+    epicsMutexUnlock(pintr->mutex);
+
+    *ppchannel = pchannel;
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Give the time of the latest interrupt to a record with TSE of -2.
+// Records without an interrupt source, or processed before the first
+// interrupt, get the current time instead.
+//
+void f3rp61_set_io_interrupt_time(dbCommon *prec, F3RP61_IO_INTR_CHANNEL *pchannel)
+{
+    if (prec->tse != epicsTimeEventDeviceTime) {
+        return;
+    }
+
+    if (!pchannel) {
+        epicsTimeGetCurrent(&prec->time);
+        return;
+    }
+
+    epicsMutexMustLock(pchannel->mutex);
+    prec->time = pchannel->time;
+    epicsMutexUnlock(pchannel->mutex);
+
+    // No interrupt yet
+    if (prec->time.secPastEpoch == 0 && prec->time.nsec == 0) {
+        epicsTimeGetCurrent(&prec->time);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Latency statistics
+//
+static double elapsed_usec(const struct timespec *from, const struct timespec *to)
+{
+    return (to->tv_sec - from->tv_sec) * 1e6 + (to->tv_nsec - from->tv_nsec) * 1e-3;
+}
+
+void f3rp61_latency_add(F3RP61_LATENCY *plat, double usec)
+{
+    if (plat->count == 0 || usec < plat->min) {
+        plat->min = usec;
+    }
+    if (plat->count == 0 || usec > plat->max) {
+        plat->max = usec;
+    }
+    plat->count++;
+    plat->sum += usec;
+
+    int bin = 0;
+    for (double limit = 1.0; usec >= limit && bin < F3RP61_LATENCY_NBINS - 1; limit *= 2.0) {
+        bin++;
+    }
+    plat->hist[bin]++;
+}
+
+double f3rp61_latency_mean(const F3RP61_LATENCY *plat)
+{
+    return plat->count ? plat->sum / plat->count : 0.0;
+}
+
+void f3rp61_latency_merge(F3RP61_LATENCY *pdst, const F3RP61_LATENCY *psrc)
+{
+    if (psrc->count == 0) {
+        return;
+    }
+    if (pdst->count == 0 || psrc->min < pdst->min) {
+        pdst->min = psrc->min;
+    }
+    if (pdst->count == 0 || psrc->max > pdst->max) {
+        pdst->max = psrc->max;
+    }
+    pdst->count += psrc->count;
+    pdst->sum   += psrc->sum;
+    for (int i = 0; i < F3RP61_LATENCY_NBINS; i++) {
+        pdst->hist[i] += psrc->hist[i];
+    }
+}
+
+static void latency_print(const char *label, const F3RP61_LATENCY *plat, int level)
+{
+    printf("    %-8s count=%lu min=%.1f mean=%.1f max=%.1f (us)\n", label,
+           plat->count, plat->min, f3rp61_latency_mean(plat), plat->max);
+
+    if (level < 2 || plat->count == 0) {
+        return;
+    }
+
+    for (int i = 0; i < F3RP61_LATENCY_NBINS; i++) {
+        if (plat->hist[i] == 0) {
+            continue;
+        }
+        if (i == 0) {
+            printf("      < 1 us : %lu\n", plat->hist[i]);
+        } else if (i == F3RP61_LATENCY_NBINS - 1) {
+            printf("      >= %lu us : %lu\n", 1UL << (i - 1), plat->hist[i]);
+        } else {
+            printf("      < %lu us : %lu\n", 1UL << i, plat->hist[i]);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Get statistics of the interrupt channel (unit, slot, channel), or the
+// sum over all the channels when unit is -1
+//
+long f3rp61_get_io_interrupt_stat(int unit, int slot, int channel, F3RP61_IO_INTR_STAT *pstat)
+{
+    memset(pstat, 0, sizeof(F3RP61_IO_INTR_STAT));
+
+    if (unit == -1) {
+        for (unit = 0; unit < M3IO_NUM_UNIT; unit++) {
+            for (slot = 1; slot < M3IO_NUM_SLOT + 1; slot++) {
+                F3RP61_IO_INTR *pintr = &io_intr[unit][slot];
+                if (!pintr->mutex) {
+                    continue;
+                }
+
+                epicsMutexMustLock(pintr->mutex);
+                for (channel = 0; channel < pintr->nchannels; channel++) {
+                    F3RP61_IO_INTR_CHANNEL *pchannel = pintr->channels[channel];
+                    if (!pchannel) {
+                        continue;
+                    }
+                    pstat->received += pchannel->stat.received;
+                    pstat->overruns += pchannel->stat.overruns;
+                    f3rp61_latency_merge(&pstat->request, &pchannel->stat.request);
+                    f3rp61_latency_merge(&pstat->complete, &pchannel->stat.complete);
+                }
+                epicsMutexUnlock(pintr->mutex);
+            }
+        }
+
+        if (intr_stat_mutex) {
+            epicsMutexMustLock(intr_stat_mutex);
+            pstat->errors    = intr_errors;
+            pstat->unmatched = intr_unmatched;
+            epicsMutexUnlock(intr_stat_mutex);
+        }
+
+        return 0;
+    }
+
+    if (unit < 0 || unit >= M3IO_NUM_UNIT || slot < 1 || slot > M3IO_NUM_SLOT || channel < 1) {
+        return -1;
+    }
+
+    F3RP61_IO_INTR *pintr = &io_intr[unit][slot];
+    if (!pintr->mutex) {
+        return -1;
+    }
+
+    long status = -1;
+    epicsMutexMustLock(pintr->mutex);
+    if (channel < pintr->nchannels && pintr->channels[channel]) {
+        *pstat = pintr->channels[channel]->stat;
+        status = 0;
+    }
+    epicsMutexUnlock(pintr->mutex);
+
+    return status;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Registers are addressed by their number while relays are addressed by
+// the number of the first relay in 16-bit words (1, 17, 33, ...). The
+// scan cache works on word indexes converted by the following functions.
+//
+static int word_index(char device, int start)
+{
+    return (device == 'X' || device == 'Y') ? (start - 1) / 16 : start;
+}
+
+static int word_start(char device, int index)
+{
+    return (device == 'X' || device == 'Y') ? index * 16 + 1 : index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Read registers or relays on an I/O module bypassing the scan cache
+//
+static long read_module(char device, int unitno, int slotno, int start, int count, uint16_t *wdata)
+{
+    M3IO_ACCESS_REG drly = {
+        .unitno = unitno,
+        .slotno = slotno,
+        .start  = start,
+        .count  = count,
+    };
+
+    if (0) {                    // dummy
+
+    } else if (device == 'A') { // I/O registers on special modules
+        drly.u.pwdata = wdata;
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG, &drly) < 0) {
+            return -1;
+        }
+
+    } else if (device == 'X') { // Input relays on I/O modules
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_INRELAY, &drly) < 0) {
+            return -1;
+        }
+        for (int i = 0; i < count; i++) {
+            wdata[i] = drly.u.inrly[i].data;
+        }
+
+    } else if (device == 'Y') { // Output relays on I/O modules
+        if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_OUTRELAY, &drly) < 0) {
+            return -1;
+        }
+        for (int i = 0; i < count; i++) {
+            wdata[i] = drly.u.outrly[i].data;
+        }
+
+    } else if (device == 'R') { // Shared registers
+        if (f3rp61_backend->readM3ComRegister(start, count, wdata) < 0) {
+            return -1;
+        }
+
+    } else {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Read I/O registers in long words with M3IO_READ_REG_L, the lower word
+// of each pair coming first in wdata. 'count' is the number of words.
+//
+static long read_module_long(int unitno, int slotno, int start, int count, uint16_t *wdata)
+{
+    unsigned long ldata[SCAN_CACHE_MAX_COUNT / 2];
+
+    if (count < 2 || count % 2 || count > SCAN_CACHE_MAX_COUNT) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    M3IO_ACCESS_REG drly = {
+        .unitno = unitno,
+        .slotno = slotno,
+        .start  = start,
+        .count  = count / 2,
+    };
+    drly.u.pldata = ldata;
+    if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_READ_REG_L, &drly) < 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < count / 2; i++) {
+        wdata[2 * i]     = ldata[i] & 0xffff;
+        wdata[2 * i + 1] = (ldata[i] >> 16) & 0xffff;
+    }
+
+    return 0;
+}
+
+// Read the words of a snapshot, or of a record bypassing it
+static long read_cache_words(const F3RP61_SCAN_CACHE *pcache, int start, int count, uint16_t *wdata)
+{
+    if (pcache->longword) {
+        return read_module_long(pcache->unitno, pcache->slotno, start, count, wdata);
+    }
+    return read_module(pcache->device, pcache->unitno, pcache->slotno, start, count, wdata);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Attach a record to the scan cache of (unit, slot, SCAN)
+//
+// Only periodically scanned records are cached. The record bypasses the
+// cache (pref->pcache is left NULL) when the cache is disabled or when
+// the range does not fit into a single transaction. For input relays (X)
+// 'start' must be the first relay of a 16-bit word and 'count' is the
+// number of words. Non-zero 'longword' tells that the record reads I/O
+// registers (A) in long words, 'count' being even.
+//
+long f3rp61_register_scan_cache(dbCommon *prec, F3RP61_SCAN_CACHE_REF *pref, char device,
+                                int unitno, int slotno, int start, int count, int longword)
+{
+    pref->pcache = NULL;
+    pref->generation = 0;
+
+    if (!scan_cache_enable || prec->scan < SCAN_1ST_PERIODIC) {
+        return 0;
+    }
+
+    int max_count;
+    if (device == 'A') {
+        max_count = SCAN_CACHE_MAX_COUNT;
+        if (longword && count % 2) {
+            return 0;
+        }
+    } else if (device == 'X') {
+        if ((start - 1) % 16) {
+            return 0; // not aligned to a word
+        }
+        max_count = SCAN_CACHE_MAX_RELAY_COUNT;
+    } else {
+        errlogPrintf("drvF3RP61: unsupported device \'%c\' for scan cache of %s\n", device, prec->name);
+        return -1;
+    }
+
+    if (count < 1 || count > max_count) {
+        return 0;
+    }
+
+    start = word_index(device, start);
+
+    F3RP61_SCAN_CACHE *pcache;
+    for (pcache = (F3RP61_SCAN_CACHE *) ellFirst(&scan_cache_list);
+         pcache;
+         pcache = (F3RP61_SCAN_CACHE *) ellNext(&pcache->node)) {
+        if (pcache->device != device || pcache->longword != !!longword ||
+            pcache->unitno != unitno || pcache->slotno != slotno || pcache->scan != prec->scan) {
+            continue;
+        }
+
+        // Long words are read in the pairs of the snapshot
+        if (pcache->longword && (start - pcache->start) % 2) {
+            continue;
+        }
+
+        // Extend the range of the snapshot if the union still fits
+        const int first = (start < pcache->start) ? start : pcache->start;
+        const int last  = (start + count > pcache->start + pcache->count) ?
+                          (start + count) : (pcache->start + pcache->count);
+        if (last - first <= max_count) {
+            pcache->start = first;
+            pcache->count = last - first;
+            break;
+        }
+    }
+
+    if (!pcache) {
+        pcache = callocMustSucceed(1, sizeof(F3RP61_SCAN_CACHE), "calloc failed");
+        pcache->mutex  = epicsMutexMustCreate();
+        pcache->device = device;
+        pcache->longword = !!longword;
+        pcache->unitno = unitno;
+        pcache->slotno = slotno;
+        pcache->scan   = prec->scan;
+        pcache->start  = start;
+        pcache->count  = count;
+        ellAdd(&scan_cache_list, &pcache->node);
+    }
+
+    // The buffer is (re)allocated when the first record gets processed,
+    // after all the records have been attached.
+    pref->pcache = pcache;
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Read words of registers or relays through the scan cache
+//
+// A new snapshot is taken when the record comes back to a snapshot it has
+// already consumed, i.e. when a new scan pass begins.
+//
+long f3rp61_read_scan_cache(dbCommon *prec, F3RP61_SCAN_CACHE_REF *pref, int start, int count, uint16_t *wdata)
+{
+    F3RP61_SCAN_CACHE *pcache = pref->pcache;
+
+    // SCAN field might have been changed at run time
+    if (prec->scan != pcache->scan) {
+        return read_cache_words(pcache, start, count, wdata);
+    }
+
+    epicsMutexMustLock(pcache->mutex);
+
+    if (!pcache->wdata) {
+        pcache->wdata = callocMustSucceed(pcache->count, sizeof(uint16_t), "calloc failed");
+    }
+
+    if (!pcache->valid || pref->generation == pcache->generation) {
+        if (read_cache_words(pcache, word_start(pcache->device, pcache->start),
+                             pcache->count, pcache->wdata) < 0) {
+            pcache->valid = 0;
+            epicsMutexUnlock(pcache->mutex);
+            return -1;
+        }
+        pcache->valid = 1;
+        pcache->generation++;
+    }
+
+    pref->generation = pcache->generation;
+    memcpy(wdata, &pcache->wdata[word_index(pcache->device, start) - pcache->start], count * sizeof(uint16_t));
+
+    epicsMutexUnlock(pcache->mutex);
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Attach a record to the output group of (unit, slot)
+//
+// 'start' is the first relay of the 16-bit word written by the record,
+// which must be one of the first 64 relays of the module. Otherwise the
+// record bypasses the group (pref->pgroup is left NULL).
+//
+long f3rp61_register_out_group(dbCommon *prec, F3RP61_OUT_GROUP_REF *pref, int unitno, int slotno, int start)
+{
+    pref->pgroup = NULL;
+    callbackSetUser(prec, &pref->callback);
+
+    if ((start - 1) % 16 || start < 1 || (start - 1) / 16 >= OUT_GROUP_MAX_RELAY_COUNT) {
+        return 0;
+    }
+
+    pref->pgroup = get_out_group(unitno, slotno);
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Attach the flush record to the output group of (unit, slot). The
+// group is then written only when the flush record is processed.
+//
+long f3rp61_register_out_group_flush(dbCommon *prec, F3RP61_OUT_GROUP **ppgroup, int unitno, int slotno)
+{
+    F3RP61_OUT_GROUP *pgroup = get_out_group(unitno, slotno);
+    if (pgroup->flush_record) {
+        errlogPrintf("drvF3RP61: output group U%d,S%d has another flush record than %s\n",
+                     unitno, slotno, prec->name);
+        return -1;
+    }
+
+    pgroup->flush_record = 1;
+    *ppgroup = pgroup;
+
+    return 0;
+}
+
+// Find or create the output group of (unit, slot)
+static F3RP61_OUT_GROUP *get_out_group(int unitno, int slotno)
+{
+    F3RP61_OUT_GROUP *pgroup;
+    for (pgroup = (F3RP61_OUT_GROUP *) ellFirst(&out_group_list);
+         pgroup;
+         pgroup = (F3RP61_OUT_GROUP *) ellNext(&pgroup->node)) {
+        if (pgroup->unitno == unitno && pgroup->slotno == slotno) {
+            return pgroup;
+        }
+    }
+
+    pgroup = callocMustSucceed(1, sizeof(F3RP61_OUT_GROUP), "calloc failed");
+    pgroup->mutex  = epicsMutexMustCreate();
+    pgroup->unitno = unitno;
+    pgroup->slotno = slotno;
+    callbackSetCallback(flush_out_group, &pgroup->callback);
+    callbackSetPriority(priorityLow, &pgroup->callback);
+    callbackSetUser(pgroup, &pgroup->callback);
+    ellAdd(&out_group_list, &pgroup->node);
+
+    return pgroup;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Write the relays in 'mask' of a word of output relays through the
+// output group
+//
+// The record is processed again once the group has been flushed, with
+// the result in pref->ret.
+//
+long f3rp61_write_out_group(dbCommon *prec, F3RP61_OUT_GROUP_REF *pref, int start, uint16_t data, uint16_t mask)
+{
+    F3RP61_OUT_GROUP *pgroup = pref->pgroup;
+    const int word = (start - 1) / 16;
+
+    epicsMutexMustLock(pgroup->mutex);
+
+    if (!pgroup->scheduled && !pgroup->flush_record) {
+        if (out_group_delay > 0.0) {
+            callbackRequestDelayed(&pgroup->callback, out_group_delay);
+        } else if (callbackRequest(&pgroup->callback)) {
+            epicsMutexUnlock(pgroup->mutex);
+            return -1;
+        }
+        pgroup->scheduled = 1;
+    }
+
+    pgroup->data[word] = (pgroup->data[word] & ~mask) | (data & mask);
+    pgroup->mask[word] |= mask;
+    pref->ret = 0;
+    ellAdd(&pgroup->pending, &pref->node);
+    pgroup->writes++;
+
+    epicsMutexUnlock(pgroup->mutex);
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Write the relays changed in the group, on processing the flush record
+//
+long f3rp61_flush_out_group(F3RP61_OUT_GROUP *pgroup)
+{
+    return write_out_group(pgroup);
+}
+
+// Flush scheduled on the first write, for a group without flush record
+static void flush_out_group(CALLBACK *pcallback)
+{
+    F3RP61_OUT_GROUP *pgroup;
+    callbackGetUser(pgroup, pcallback);
+
+    write_out_group(pgroup);
+}
+
+// Write the relays changed in the group with one ioctl(), and complete
+// the records waiting for it
+static int write_out_group(F3RP61_OUT_GROUP *pgroup)
+{
+    epicsMutexMustLock(pgroup->mutex);
+
+    int first = OUT_GROUP_MAX_RELAY_COUNT, last = -1;
+    for (int i = 0; i < OUT_GROUP_MAX_RELAY_COUNT; i++) {
+        if (pgroup->mask[i]) {
+            if (i < first) {
+                first = i;
+            }
+            last = i;
+        }
+    }
+
+    int ret = 0;
+    if (last >= 0) {
+        M3IO_ACCESS_REG drly;
+        memset(&drly, 0, sizeof(drly));
+        drly.unitno = pgroup->unitno;
+        drly.slotno = pgroup->slotno;
+        drly.start  = 16 * first + 1;
+        drly.count  = last - first + 1;
+        for (int i = first; i <= last; i++) {
+            drly.u.outrly[i - first].data = pgroup->data[i];
+            drly.u.outrly[i - first].mask = pgroup->mask[i];
+            pgroup->mask[i] = 0;
+        }
+
+        ret = f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_OUTRELAY, &drly);
+        if (ret < 0) {
+            errlogPrintf("drvF3RP61: ioctl failed [%d] for output group U%d,S%d\n",
+                         errno, pgroup->unitno, pgroup->slotno);
+        }
+        pgroup->flushes++;
+    }
+
+    // The records may write to the group again on processing
+    ELLLIST pending = pgroup->pending;
+    ellInit(&pgroup->pending);
+    pgroup->scheduled = 0;
+
+    epicsMutexUnlock(pgroup->mutex);
+
+    F3RP61_OUT_GROUP_REF *pref;
+    while ((pref = (F3RP61_OUT_GROUP_REF *) ellGet(&pending))) {
+        dbCommon *prec;
+        callbackGetUser(prec, &pref->callback);
+        pref->ret = ret;
+        const int priority = (prec->prio < NUM_CALLBACK_PRIORITIES) ? prec->prio : priorityHigh;
+        callbackRequestProcessCallback(&pref->callback, priority, prec);
+    }
+
+    return ret;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Strip the &S option, which may come along with another option, e.g.
+// "&L&S", from the address of an output record. Returns 1 if found.
+//
+int f3rp61_parse_suppress_option(char *buf)
+{
+    return strip_option(buf, "&S");
+}
+
+// Strip an option from the address. Returns 1 if found.
+static int strip_option(char *buf, const char *option)
+{
+    char *popt = strstr(buf, option);
+    if (!popt) {
+        return 0;
+    }
+
+    const size_t len = strlen(option);
+    memmove(popt, popt + len, strlen(popt + len) + 1);
+    return 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Check if the words about to be written are those last written by the
+// record, in which case the write is to be skipped. Otherwise the last
+// value is forgotten until the write succeeds.
+//
+int f3rp61_is_write_unchanged(F3RP61_LAST_WRITE *plast, const uint16_t *wdata, int count)
+{
+    if (!plast->enabled) {
+        return 0;
+    }
+
+    const epicsUInt64 now = epicsMonotonicGet();
+
+    if (plast->valid && plast->count == count &&
+        !memcmp(plast->wdata, wdata, count * sizeof(uint16_t)) &&
+        (write_refresh <= 0.0 || (now - plast->written) * 1e-9 < write_refresh)) {
+        epicsAtomicIncrSizeT(&write_suppressed);
+        return 1;
+    }
+
+    plast->valid = 0;
+    epicsAtomicIncrSizeT(&write_issued);
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Remember the words written successfully by the record
+//
+void f3rp61_set_last_write(F3RP61_LAST_WRITE *plast, const uint16_t *wdata, int count)
+{
+    if (!plast->enabled) {
+        return;
+    }
+
+    memcpy(plast->wdata, wdata, count * sizeof(uint16_t));
+    plast->count = count;
+    plast->written = epicsMonotonicGet();
+    plast->valid = 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Strip the &T option, which may come along with another option, e.g.
+// "&L&T", from the address of an output record. Returns 1 if found.
+//
+int f3rp61_parse_staged_option(char *buf)
+{
+    return strip_option(buf, "&T");
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Attach a record to the staging area of I/O registers of (unit, slot)
+//
+// Output records stage 'count' registers from 'start'. The commit record
+// gives 'count' of 0. All the registers staged on a module must fit into
+// a single transaction.
+//
+long f3rp61_register_stage(dbCommon *prec, F3RP61_STAGE **ppstage, int unitno, int slotno, int start, int count)
+{
+    F3RP61_STAGE *pstage;
+    for (pstage = (F3RP61_STAGE *) ellFirst(&stage_list);
+         pstage;
+         pstage = (F3RP61_STAGE *) ellNext(&pstage->node)) {
+        if (pstage->unitno == unitno && pstage->slotno == slotno) {
+            break;
+        }
+    }
+
+    if (!pstage) {
+        pstage = callocMustSucceed(1, sizeof(F3RP61_STAGE), "calloc failed");
+        pstage->mutex  = epicsMutexMustCreate();
+        pstage->unitno = unitno;
+        pstage->slotno = slotno;
+        ellAdd(&stage_list, &pstage->node);
+    }
+
+    if (count > 0) {
+        const int first = (pstage->count && pstage->start < start) ? pstage->start : start;
+        const int last  = (pstage->count && pstage->start + pstage->count > start + count) ?
+                          (pstage->start + pstage->count) : (start + count);
+        if (last - first > STAGE_MAX_COUNT) {
+            errlogPrintf("drvF3RP61: registers staged on U%d,S%d span more than %d words for %s\n",
+                         unitno, slotno, STAGE_MAX_COUNT, prec->name);
+            return -1;
+        }
+        pstage->start = first;
+        pstage->count = last - first;
+    }
+
+    // The buffers are allocated when the first record gets processed,
+    // after all the records have been attached.
+    *ppstage = pstage;
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Stage words to be written to I/O registers from 'start' on the next
+// commit
+//
+long f3rp61_write_stage(F3RP61_STAGE *pstage, int start, const uint16_t *wdata, int count)
+{
+    epicsMutexMustLock(pstage->mutex);
+
+    if (!pstage->wdata) {
+        pstage->wdata = callocMustSucceed(pstage->count, sizeof(uint16_t), "calloc failed");
+        pstage->dirty = callocMustSucceed(pstage->count, sizeof(uint8_t), "calloc failed");
+    }
+
+    const int index = start - pstage->start;
+    memcpy(&pstage->wdata[index], wdata, count * sizeof(uint16_t));
+    memset(&pstage->dirty[index], 1, count);
+    pstage->writes++;
+
+    epicsMutexUnlock(pstage->mutex);
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Write the registers staged since the last commit. The registers are
+// staged again until they are written successfully.
+//
+long f3rp61_commit_stage(F3RP61_STAGE *pstage)
+{
+    long ret = 0;
+
+    epicsMutexMustLock(pstage->mutex);
+
+    if (pstage->wdata) {
+        int committed = 0;
+        for (int i = 0; i < pstage->count; ) {
+            if (!pstage->dirty[i]) {
+                i++;
+                continue;
+            }
+
+            int n = 1;
+            while (i + n < pstage->count && pstage->dirty[i + n]) {
+                n++;
+            }
+
+            M3IO_ACCESS_REG drly;
+            memset(&drly, 0, sizeof(drly));
+            drly.unitno = pstage->unitno;
+            drly.slotno = pstage->slotno;
+            drly.start  = pstage->start + i;
+            drly.count  = n;
+            drly.u.pwdata = &pstage->wdata[i];
+            if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_REG, &drly) < 0) {
+                ret = -1;
+            } else {
+                memset(&pstage->dirty[i], 0, n);
+                committed = 1;
+            }
+
+            i += n;
+        }
+
+        if (committed) {
+            pstage->commits++;
+        }
+    }
+
+    epicsMutexUnlock(pstage->mutex);
+
+    return ret;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Parse the option to ramp to the value at a rate, e.g. "&R0.5" for 0.5
+// per second, and strip it from the address. Returns 1 if found, -1 if
+// the rate is not valid.
+//
+int f3rp61_parse_ramp_option(char *buf, double *prate)
+{
+    char *popt = strstr(buf, "&R");
+    if (!popt) {
+        return 0;
+    }
+
+    char *pend;
+    const double rate = strtod(popt + 2, &pend);
+    memmove(popt, pend, strlen(pend) + 1);
+    if (pend == popt + 2 || !(rate > 0.0)) {
+        return -1;
+    }
+
+    *prate = rate;
+    return 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Create the ramp of an ao record on I/O registers (A) or shared
+// registers (R). The ramp thread is started with the first ramp.
+//
+long f3rp61_register_ramp(dbCommon *prec, F3RP61_RAMP **ppramp, char device, int unitno, int slotno,
+                          int start, char option, double rate)
+{
+    if (!ramp_mutex) {
+        ramp_mutex = epicsMutexMustCreate();
+        if (epicsThreadCreate("f3rp61_ramp",
+                              epicsThreadPriorityHigh,
+                              epicsThreadGetStackSize(epicsThreadStackSmall),
+                              (EPICSTHREADFUNC) ramp_thread,
+                              NULL) == 0) {
+            errlogPrintf("drvF3RP61: epicsThreadCreate failed\n");
+            return -1;
+        }
+    }
+
+    F3RP61_RAMP *pramp = callocMustSucceed(1, sizeof(F3RP61_RAMP), "calloc failed");
+    pramp->prec   = prec;
+    pramp->device = device;
+    pramp->option = option;
+    pramp->unitno = unitno;
+    pramp->slotno = slotno;
+    pramp->start  = start;
+    pramp->rate   = rate;
+
+    epicsMutexMustLock(ramp_mutex);
+    ellAdd(&ramp_list, &pramp->node);
+    epicsMutexUnlock(ramp_mutex);
+
+    *ppramp = pramp;
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Set the target of a ramp. The first target is written as is, unless
+// the value on the device is known.
+//
+void f3rp61_write_ramp(F3RP61_RAMP *pramp, double target)
+{
+    epicsMutexMustLock(ramp_mutex);
+    pramp->target = target;
+    pramp->active = 1;
+    epicsMutexUnlock(ramp_mutex);
+}
+
+// Set the value on the device, e.g. read back at iocInit, to ramp from
+void f3rp61_set_ramp(F3RP61_RAMP *pramp, double value)
+{
+    epicsMutexMustLock(ramp_mutex);
+    pramp->value  = value;
+    pramp->target = value;
+    pramp->valid  = 1;
+    epicsMutexUnlock(ramp_mutex);
+}
+
+// The bus is written with the lock released, so that the records
+// setting the targets do not wait for the writes of all the ramps. The
+// step is timed by the monotonic clock, unaffected by steps of the time.
+static void ramp_thread(void *arg)
+{
+    epicsUInt64 last = epicsMonotonicGet();
+
+    for (;;) {
+        epicsThreadSleep(ramp_period);
+
+        const epicsUInt64 now = epicsMonotonicGet();
+        const double elapsed = (now - last) * 1e-9;
+        last = now;
+
+        epicsMutexMustLock(ramp_mutex);
+        F3RP61_RAMP *pramp = (F3RP61_RAMP *) ellFirst(&ramp_list);
+        while (pramp) {
+            if (!pramp->active) {
+                pramp = (F3RP61_RAMP *) ellNext(&pramp->node);
+                continue;
+            }
+
+            // Step towards the target, or jump to it if where it starts
+            // from is not known (or either is NaN)
+            const double step = pramp->rate * elapsed;
+            const double target = pramp->target;
+            double value = pramp->value;
+            const int reached = !pramp->valid || !(fabs(target - value) > step);
+            if (reached) {
+                value = target;
+            } else if (target > value) {
+                value += step;
+            } else {
+                value -= step;
+            }
+
+            epicsMutexUnlock(ramp_mutex);
+            const int ret = write_ramp_value(pramp, value);
+            const int err = errno;
+            epicsMutexMustLock(ramp_mutex);
+
+            // Retry the same step next time if the write fails
+            if (ret < 0) {
+                pramp->errors++;
+                if (!pramp->failing) {
+                    errlogPrintf("drvF3RP61: ramp write failed [%d] for %s\n", err, pramp->prec->name);
+                }
+                pramp->failing = 1;
+            } else {
+                pramp->value = value;
+                pramp->writes++;
+                pramp->failing = 0;
+                pramp->valid = 1;
+                if (reached && pramp->target == target) { // not set again while writing
+                    pramp->active = 0;
+                }
+            }
+
+            pramp = (F3RP61_RAMP *) ellNext(&pramp->node);
+        }
+        epicsMutexUnlock(ramp_mutex);
+    }
+}
+
+// Write a value of a ramp as the ao record would. Only the fields set
+// on registration are used, without the lock.
+static int write_ramp_value(const F3RP61_RAMP *pramp, double value)
+{
+    const char option = pramp->option;
+    uint16_t wdata[4] = {0};
+    int count = 1;
+    if (option == 'D') {
+        devF3RP61double2words(value, wdata);
+        count = 4;
+    } else if (option == 'F') {
+        devF3RP61float2words(value, wdata);
+        count = 2;
+    } else if (option == 'L') {
+        devF3RP61long2words((uint32_t)(int32_t) lround(value), wdata);
+        count = 2;
+    } else {
+        wdata[0] = (uint16_t) lround(value);
+    }
+
+    if (pramp->device == 'R') { // Shared registers
+        return f3rp61_backend->writeM3ComRegister(pramp->start, count, wdata);
+    }
+
+    // I/O registers on special modules
+    M3IO_ACCESS_REG drly;
+    memset(&drly, 0, sizeof(drly));
+    drly.unitno = pramp->unitno;
+    drly.slotno = pramp->slotno;
+    drly.start  = pramp->start;
+    drly.count  = count;
+    drly.u.pwdata = wdata;
+    return f3rp61_backend->ioctl(f3rp61_fd, M3IO_WRITE_REG, &drly);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Call a function with the record type and the OUT field of each output
+// record of a DTYP in the database, before the records are initialized
+//
+void f3rp61_for_each_output(const char *dtyp, F3RP61_OUTPUT_FUNC func, void *arg)
+{
+    static const char *record_types[] = {
+        "ao", "longout", "bo", "mbbo", "mbboDirect",
+    };
+
+    DBENTRY dbentry;
+    dbInitEntry(pdbbase, &dbentry);
 
-            if (setM3LinkDeviceConfig(&link_data_config) < 0) {
-                errlogPrintf("drvF3RP61: setM3LinkDeviceConfig failed [%d]\n", errno);
-                return -1;
+    for (long status = dbFirstRecordType(&dbentry); !status; status = dbNextRecordType(&dbentry)) {
+        const char *record_type = dbGetRecordTypeName(&dbentry);
+        size_t i;
+        for (i = 0; i < NELEMENTS(record_types); i++) {
+            if (!strcmp(record_type, record_types[i])) {
+                break;
             }
+        }
+        if (i == NELEMENTS(record_types)) {
+            continue;
+        }
 
-            if (setM3FlnSysNo(0, NULL) < 0) {
-                errlogPrintf("drvF3RP61: setM3FlnSysNo failed [%d]\n", errno);
-                // 414 (invalid number)  : invalid parameter was specified (F3RP71/61)
-                // 415 (device mismatch) : specified modules is not FL-net (F3RP71)
-                // 416 (number over)     : an excessive number of system is specified (F3RP71)
-                // 417 (entry error)     : unable to access module or I/O bus error (F3RP71)
-                // 397 (internal error)  : (F3RP61)
-                // 394                   : Not documented in the manual; setM3FlnSysNo() was called after m3rfrsTsk(). We'd better to reset the CPU.
-                return -1;
+        for (status = dbFirstRecord(&dbentry); !status; status = dbNextRecord(&dbentry)) {
+            if (dbFindField(&dbentry, "DTYP") || strcmp(dbGetString(&dbentry), dtyp)) {
+                continue;
             }
-
-            if (m3rfrsTsk(10) < 0) {
-                errlogPrintf("drvF3RP61: m3rfrsTsk failed [%d]\n", errno);
-                return -1;
+            if (dbFindField(&dbentry, "OUT")) {
+                continue;
             }
-
-            break;
+            func(record_type, dbGetString(&dbentry), arg);
         }
-
     }
 
-    return 0;
+    dbFinishEntry(&dbentry);
 }
 
+//////////////////////////////////////////////////////////////////////////
 //
-static void msgrcv_thread(void *arg)
+// Add the words written by an output record to the readback, as in
+// f3rp61_register_scan_cache()
+//
+static void add_readback(char device, int unitno, int slotno, int start, int count)
 {
-    int msqid = (int) arg;
+    const int max_count = (device == 'Y') ? READBACK_MAX_RELAY_COUNT : READBACK_MAX_COUNT;
 
-    for (;;) {
-        MSG_BUF msgbuf;
-        const ssize_t val = msgrcv(msqid, &msgbuf, sizeof(MSG_BUF), M3IO_MSGTYPE_IO, MSG_NOERROR);
+    // Output relays beyond the module are not read, nor merged with
+    if (device == 'Y') {
+        const int words = module_relay_words(unitno, slotno);
+        if (words > 0 && start + count > words) {
+            count = words - start;
+        }
+    }
 
-        if (val == -1) {
-            errlogPrintf("drvF3RP61: msgrcv failed [%d] : %s\n", errno, strerror(errno));
-            // msgbuf might be uninitialized if msgrcv() failed.
+    if (count < 1 || count > max_count) {
+        return;
+    }
+
+    F3RP61_READBACK *preadback;
+    for (preadback = (F3RP61_READBACK *) ellFirst(&readback_list);
+         preadback;
+         preadback = (F3RP61_READBACK *) ellNext(&preadback->node)) {
+        if (preadback->device != device || preadback->unitno != unitno || preadback->slotno != slotno) {
             continue;
         }
 
-        if (val < 16) {
-            // for just in case
-            errlogPrintf("drvF3RP61: message received by msgrcv() is too small (%d bytes)\n", val);
-            continue;
+        // Extend the range if the union still fits
+        const int first = (start < preadback->start) ? start : preadback->start;
+        const int last  = (start + count > preadback->start + preadback->count) ?
+                          (start + count) : (preadback->start + preadback->count);
+        if (last - first <= max_count) {
+            preadback->start = first;
+            preadback->count = last - first;
+            return;
         }
+    }
 
-        const int unit    = msgbuf.mtext.unit;
-        const int slot    = msgbuf.mtext.slot;
-        const int channel = msgbuf.mtext.channel;
+    preadback = callocMustSucceed(1, sizeof(F3RP61_READBACK), "calloc failed");
+    preadback->device = device;
+    preadback->unitno = unitno;
+    preadback->slotno = slotno;
+    preadback->start  = start;
+    preadback->count  = count;
+    ellAdd(&readback_list, &preadback->node);
+}
 
-        for (int i = 0; i < io_intr[unit][slot].count; i++) {
-            if (io_intr[unit][slot].ioscan[i].channel == channel) {
-                dbCommon *prec = io_intr[unit][slot].ioscan[i].prec;
-                if (!prec) {
-                    errlogPrintf("drvF3RP61: no record for interrupt (U%d,S%d,C%d)\n", unit, slot, channel);
-                    break;
-                }
+// Number of words of output relays on a module, or 0 if not known
+static int module_relay_words(int unitno, int slotno)
+{
+    M3IO_MODULE_INFORMATION module_info = {
+        .unitno = unitno,
+        .slotno = slotno,
+    };
 
-                if (prec->scan == SCAN_IO_EVENT) {
-                    IOSCANPVT ioscanpvt = *((IOSCANPVT *) prec->dpvt);
-                    scanIoRequest(ioscanpvt);
-                }
-            }
-        }
+    if (f3rp61_backend->ioctl(f3rp61_fd, M3IO_GET_MODULE_INFO, &module_info) < 0 ||
+        !module_info.enable) {
+        return 0;
     }
+
+    return module_info.num_yreg;
 }
 
 //////////////////////////////////////////////////////////////////////////
 //
-long f3rp61_register_io_interrupt(dbCommon *prec, int unit, int slot, int channel)
+// Add the output relays (Y), I/O registers (A) or shared registers (R)
+// written by an output record to the readback. The OUT field is parsed
+// as by the device supports, e.g. "@U0,S2,Y1&L".
+//
+static void find_readback(const char *record_type, const char *out, void *arg)
 {
-    char thread_name[32];
-    int msqid = 0;
-    int count = io_intr[unit][slot].count;
+    char buf[80];
+    strncpy(buf, (out[0] == '@') ? &out[1] : out, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    // Number of words written, from the option
+    int count = 1;
+    if (strstr(buf, "&D")) {
+        count = 4;
+    } else if (strstr(buf, "&L") || strstr(buf, "&F")) {
+        count = 2;
+    }
 
-    if (count == NUM_IO_INTR) {
-        errlogPrintf("drvF3RP61: no interrupt slot\n");
-        return -1;
+    char *pend = strpbrk(buf, "&:");
+    if (pend) {
+        *pend = '\0';
     }
 
-    // Create a SysV message queue and a thread which reveices the message
-    if (count == 0) {
-        msqid = msgget(IPC_PRIVATE, IPC_CREAT | 0666);
-        if (msqid  == -1) {
-            errlogPrintf("drvF3RP61: msgget failed [%d] : %s\n", errno, strerror(errno));
-            return -1;
+    int unitno = 0, slotno = 0, start = 0;
+    char device = 0;
+    if (sscanf(buf, "U%d,S%d,%c%d", &unitno, &slotno, &device, &start) == 4) {
+        if (device == 'Y' && start > 0) {
+            // Words holding the relays written, the one holding the relay
+            // for bo records
+            const int bits  = strcmp(record_type, "bo") ? 16 * count : 1;
+            const int first = (start - 1) / 16;
+            const int last  = (start - 1 + bits - 1) / 16;
+            add_readback('Y', unitno, slotno, first, last - first + 1);
+        } else if (device == 'A') {
+            add_readback('A', unitno, slotno, start, count);
         }
+    } else if (sscanf(buf, "R%d", &start) == 1) {
+        add_readback('R', 0, 0, start, count);
+    }
+}
 
-#if defined(__powerpc__)
-        if (msqid == 0) {
-            // Get another message queue ID when it's 0.
-            // Message queue id 0 is valid in SysV IPC but invalid in F3RP61 BSP.
-            msqid = msgget(IPC_PRIVATE, IPC_CREAT | 0666);
-            if (msqid == -1) {
-                errlogPrintf("drvF3RP61: msgget failed [%d] : %s\n", errno, strerror(errno));
-                return -1;
-            }
+//////////////////////////////////////////////////////////////////////////
+//
+// Read all the words to read back
+//
+static void take_readbacks(void)
+{
+    for (F3RP61_READBACK *preadback = (F3RP61_READBACK *) ellFirst(&readback_list);
+         preadback;
+         preadback = (F3RP61_READBACK *) ellNext(&preadback->node)) {
+        preadback->wdata = callocMustSucceed(preadback->count, sizeof(uint16_t), "calloc failed");
+        if (read_module(preadback->device, preadback->unitno, preadback->slotno,
+                        word_start(preadback->device, preadback->start), preadback->count, preadback->wdata) < 0) {
+            errlogPrintf("drvF3RP61: can't read back U%d,S%d,%c%d [%d]\n",
+                         preadback->unitno, preadback->slotno, preadback->device,
+                         word_start(preadback->device, preadback->start), errno);
+            continue;
         }
-#endif
+        preadback->valid = 1;
+    }
+}
 
-        sprintf(thread_name, "msgrcvr%d", msqid);
-        if (epicsThreadCreate(thread_name,
-                              epicsThreadPriorityHigh,
-                              epicsThreadGetStackSize(epicsThreadStackSmall),
-                              (EPICSTHREADFUNC) msgrcv_thread,
-                              (void *)msqid) == 0) {
-            errlogPrintf("drvF3RP61: epicsThreadCreate failed\n");
-            return -1;
-        }
+//////////////////////////////////////////////////////////////////////////
+//
+// Get the words read back for an output record at iocInit. For output
+// relays (Y) 'start' must be the first relay of a 16-bit word and
+// 'count' is the number of words. Returns -1 if they have not been read.
+//
+long f3rp61_get_readback(char device, int unitno, int slotno, int start, int count, uint16_t *wdata)
+{
+    if (device == 'Y' && (start - 1) % 16) {
+        return -1; // not aligned to a word
+    }
+    if (device == 'R') {
+        unitno = slotno = 0;
     }
 
-    io_intr[unit][slot].ioscan[count].channel = channel;
-    io_intr[unit][slot].ioscan[count].prec = prec;
-    io_intr[unit][slot].count++;
+    start = word_index(device, start);
 
-    for (int i = 0; i < count; i++) {
-        if (io_intr[unit][slot].ioscan[i].channel == channel) {
+    for (F3RP61_READBACK *preadback = (F3RP61_READBACK *) ellFirst(&readback_list);
+         preadback;
+         preadback = (F3RP61_READBACK *) ellNext(&preadback->node)) {
+        if (preadback->valid && preadback->device == device &&
+            preadback->unitno == unitno && preadback->slotno == slotno &&
+            preadback->start <= start && start + count <= preadback->start + preadback->count) {
+            memcpy(wdata, &preadback->wdata[start - preadback->start], count * sizeof(uint16_t));
             return 0;
         }
     }
 
-    M3IO_INTER_DEFINE arg = {
-        .unitno = unit,
-        .slotno = slot,
-        .defData.relayNo = channel,
-        .msgQId = msqid,
-    };
-
-    if (ioctl(f3rp61_fd, M3IO_ENABLE_INTER, &arg) < 0) {
-        errlogPrintf("drvF3RP61: ioctl failed [%d]\n", errno);
-        return -1;
-    }
+    return -1;
+}
 
-    return 0;
+int f3rp61_readback_enabled(void)
+{
+    return readback_enable;
 }
 
 //////////////////////////////////////////////////////////////////////////
 //
 // Get io interrupt info
 //
+// Records with an interrupt source get the IOSCANPVT shared by the
+// interrupt channel. The others get one of their own, which is never
+// requested to scan.
+//
 long f3rp61GetIoIntInfo(int cmd, dbCommon *pxx, IOSCANPVT *ppvt)
 {
     if (!pxx->dpvt) {
@@ -286,11 +1979,17 @@ long f3rp61GetIoIntInfo(int cmd, dbCommon *pxx, IOSCANPVT *ppvt)
         return -1;
     }
 
-    if ( *((IOSCANPVT *) pxx->dpvt) == NULL) {
-        scanIoInit((IOSCANPVT *) pxx->dpvt);
+    F3RP61_IO_INTR_DPVT *dpvt = (F3RP61_IO_INTR_DPVT *) pxx->dpvt;
+
+    if (dpvt->ioscanpvt == NULL) {
+        if (dpvt->intr) {
+            dpvt->ioscanpvt = dpvt->intr->ioscanpvt;
+        } else {
+            scanIoInit(&dpvt->ioscanpvt);
+        }
     }
 
-    *ppvt = *((IOSCANPVT *) pxx->dpvt);
+    *ppvt = dpvt->ioscanpvt;
 
     return 0;
 }
@@ -381,6 +2080,335 @@ static void comDeviceConfigure(int cpuno, int nrlys, int nregs, int ext_nrlys, i
     ext_com_data_config.wNumberOfRegister[cpuno] = ext_nregs;
 }
 
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61ScanCacheConfigure'
+//
+// usage: f3rp61ScanCacheConfigure enable
+//
+// Enable (non-zero) or disable (0) the scan cache for records which are
+// initialized afterwards. The scan cache is enabled by default.
+//
+static const iocshArg scanCacheConfigureArg0 = { "enable", iocshArgInt};
+static const iocshArg *scanCacheConfigureArgs[] = {
+    &scanCacheConfigureArg0,
+};
+
+static const iocshFuncDef scanCacheConfigureFuncDef = {
+    "f3rp61ScanCacheConfigure",
+    1,
+    scanCacheConfigureArgs
+};
+
+static void scanCacheConfigureCallFunc(const iocshArgBuf *args)
+{
+    scanCacheConfigure(args[0].ival);
+}
+
+static void scanCacheConfigure(int enable)
+{
+    scan_cache_enable = enable ? 1 : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61OutGroupConfigure'
+//
+// usage: f3rp61OutGroupConfigure delay
+//
+// Flush the writes of output groups (records on output relays with the
+// &G option) delay seconds after the first write of a pass, instead of
+// as soon as the low priority callback thread gets to run, so that the
+// writes of the records processed on other CPUs at the same time are
+// also taken into the same transaction.
+//
+static const iocshArg outGroupConfigureArg0 = { "delay", iocshArgDouble};
+static const iocshArg *outGroupConfigureArgs[] = {
+    &outGroupConfigureArg0,
+};
+
+static const iocshFuncDef outGroupConfigureFuncDef = {
+    "f3rp61OutGroupConfigure",
+    1,
+    outGroupConfigureArgs
+};
+
+static void outGroupConfigureCallFunc(const iocshArgBuf *args)
+{
+    outGroupConfigure(args[0].dval);
+}
+
+static void outGroupConfigure(double delay)
+{
+    out_group_delay = (delay > 0.0) ? delay : 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61WriteSuppressConfigure'
+//
+// usage: f3rp61WriteSuppressConfigure refresh
+//
+// Write the value of output records with the &S option again, even if
+// unchanged, when it was last written more than refresh seconds ago.
+// With refresh of 0 (default), unchanged values are never written.
+//
+static const iocshArg writeSuppressConfigureArg0 = { "refresh", iocshArgDouble};
+static const iocshArg *writeSuppressConfigureArgs[] = {
+    &writeSuppressConfigureArg0,
+};
+
+static const iocshFuncDef writeSuppressConfigureFuncDef = {
+    "f3rp61WriteSuppressConfigure",
+    1,
+    writeSuppressConfigureArgs
+};
+
+static void writeSuppressConfigureCallFunc(const iocshArgBuf *args)
+{
+    writeSuppressConfigure(args[0].dval);
+}
+
+static void writeSuppressConfigure(double refresh)
+{
+    write_refresh = (refresh > 0.0) ? refresh : 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61ReadbackConfigure'
+//
+// usage: f3rp61ReadbackConfigure enable
+//
+// Enable (non-zero) or disable (0) the readback of the output records at
+// iocInit, so that the records of DTYP F3RP61 and F3RP61Seq start from
+// the values on the hardware. The readback is disabled by default. Must
+// be called prior to iocInit.
+//
+static const iocshArg readbackConfigureArg0 = { "enable", iocshArgInt};
+static const iocshArg *readbackConfigureArgs[] = {
+    &readbackConfigureArg0,
+};
+
+static const iocshFuncDef readbackConfigureFuncDef = {
+    "f3rp61ReadbackConfigure",
+    1,
+    readbackConfigureArgs
+};
+
+static void readbackConfigureCallFunc(const iocshArgBuf *args)
+{
+    readbackConfigure(args[0].ival);
+}
+
+static void readbackConfigure(int enable)
+{
+    readback_enable = enable ? 1 : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61RampConfigure'
+//
+// usage: f3rp61RampConfigure period
+//
+// Write the values of ramps (ao records with the &R option) every period
+// seconds, 0.01 by default. Must be called prior to iocInit.
+//
+static const iocshArg rampConfigureArg0 = { "period", iocshArgDouble};
+static const iocshArg *rampConfigureArgs[] = {
+    &rampConfigureArg0,
+};
+
+static const iocshFuncDef rampConfigureFuncDef = {
+    "f3rp61RampConfigure",
+    1,
+    rampConfigureArgs
+};
+
+static void rampConfigureCallFunc(const iocshArgBuf *args)
+{
+    rampConfigure(args[0].dval);
+}
+
+static void rampConfigure(double period)
+{
+    if (period <= 0.0) {
+        errlogPrintf("drvF3RP61: invalid ramp period %g\n", period);
+        return;
+    }
+    ramp_period = period;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61InterruptConfigure'
+//
+// usage: f3rp61InterruptConfigure nQueues nThreads priority cpuMask
+//
+// Route interrupts of all the slots to nQueues message queues served by
+// a pool of nThreads receiver threads (at least one thread per queue).
+// With nQueues of 0, a queue and a thread are created for each slot.
+// Priority of the receiver threads defaults to epicsThreadPriorityHigh
+// when 0 is given. Non-zero cpuMask sets CPU affinity of the threads
+// (bit 0 for CPU0, bit 1 for CPU1, ...). Must be called prior to iocInit.
+//
+static const iocshArg interruptConfigureArg0 = { "nQueues",  iocshArgInt};
+static const iocshArg interruptConfigureArg1 = { "nThreads", iocshArgInt};
+static const iocshArg interruptConfigureArg2 = { "priority", iocshArgInt};
+static const iocshArg interruptConfigureArg3 = { "cpuMask",  iocshArgInt};
+static const iocshArg *interruptConfigureArgs[] = {
+    &interruptConfigureArg0,
+    &interruptConfigureArg1,
+    &interruptConfigureArg2,
+    &interruptConfigureArg3,
+};
+
+static const iocshFuncDef interruptConfigureFuncDef = {
+    "f3rp61InterruptConfigure",
+    4,
+    interruptConfigureArgs
+};
+
+static void interruptConfigureCallFunc(const iocshArgBuf *args)
+{
+    interruptConfigure(args[0].ival, args[1].ival, args[2].ival, args[3].ival);
+}
+
+static void interruptConfigure(int nqueues, int nthreads, int priority, int cpumask)
+{
+    if (intr_started) {
+        errlogPrintf("f3rp61InterruptConfigure: receivers already started\n");
+        return;
+    }
+    if (nqueues < 0 || nqueues > M3IO_NUM_UNIT * M3IO_NUM_SLOT) {
+        errlogPrintf("f3rp61InterruptConfigure: number of queues out of range\n");
+        return;
+    }
+    if (nthreads < 0 || nthreads > 64) {
+        errlogPrintf("f3rp61InterruptConfigure: number of threads out of range\n");
+        return;
+    }
+    if (priority < 0 || priority > epicsThreadPriorityMax) {
+        errlogPrintf("f3rp61InterruptConfigure: priority out of range\n");
+        return;
+    }
+
+    intr_num_queues  = nqueues;
+    intr_num_threads = (nthreads < nqueues) ? nqueues : nthreads;
+    intr_priority    = priority ? priority : epicsThreadPriorityHigh;
+    intr_cpu_mask    = cpumask;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61InterruptStats'
+//
+// usage: f3rp61InterruptStats level
+//
+// Show statistics of the interrupt channels. Level 1 or higher shows
+// each of the channels, and level 2 or higher shows latency histograms.
+//
+static const iocshArg interruptStatsArg0 = { "level", iocshArgInt};
+static const iocshArg *interruptStatsArgs[] = {
+    &interruptStatsArg0,
+};
+
+static const iocshFuncDef interruptStatsFuncDef = {
+    "f3rp61InterruptStats",
+    1,
+    interruptStatsArgs
+};
+
+static void interruptStatsCallFunc(const iocshArgBuf *args)
+{
+    interruptStats(args[0].ival);
+}
+
+static void interruptStats(int level)
+{
+    F3RP61_IO_INTR_STAT stat;
+
+    f3rp61_get_io_interrupt_stat(-1, 0, 0, &stat);
+    printf("Interrupts: received=%lu overruns=%lu errors=%lu unmatched=%lu\n",
+           stat.received, stat.overruns, stat.errors, stat.unmatched);
+    latency_print("request", &stat.request, level);
+#if defined(HAS_IO_SCAN_COMPLETE)
+    latency_print("complete", &stat.complete, level);
+#endif
+
+    if (level < 1) {
+        return;
+    }
+
+    for (int unit = 0; unit < M3IO_NUM_UNIT; unit++) {
+        for (int slot = 1; slot < M3IO_NUM_SLOT + 1; slot++) {
+            F3RP61_IO_INTR *pintr = &io_intr[unit][slot];
+            if (!pintr->mutex) {
+                continue;
+            }
+
+            for (int channel = 1; channel < pintr->nchannels; channel++) {
+                if (f3rp61_get_io_interrupt_stat(unit, slot, channel, &stat) < 0) {
+                    continue;
+                }
+                printf("  U%d,S%d,X%d: received=%lu overruns=%lu\n",
+                       unit, slot, channel, stat.received, stat.overruns);
+                latency_print("request", &stat.request, level);
+#if defined(HAS_IO_SCAN_COMPLETE)
+                latency_print("complete", &stat.complete, level);
+#endif
+            }
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61InterruptStatsReset'
+//
+// usage: f3rp61InterruptStatsReset
+//
+// Clear statistics of the interrupt channels.
+//
+static const iocshFuncDef interruptStatsResetFuncDef = {
+    "f3rp61InterruptStatsReset",
+    0,
+    NULL
+};
+
+static void interruptStatsResetCallFunc(const iocshArgBuf *args)
+{
+    interruptStatsReset();
+}
+
+static void interruptStatsReset(void)
+{
+    for (int unit = 0; unit < M3IO_NUM_UNIT; unit++) {
+        for (int slot = 1; slot < M3IO_NUM_SLOT + 1; slot++) {
+            F3RP61_IO_INTR *pintr = &io_intr[unit][slot];
+            if (!pintr->mutex) {
+                continue;
+            }
+
+            epicsMutexMustLock(pintr->mutex);
+            for (int channel = 0; channel < pintr->nchannels; channel++) {
+                if (pintr->channels[channel]) {
+                    memset(&pintr->channels[channel]->stat, 0, sizeof(F3RP61_IO_INTR_STAT));
+                }
+            }
+            epicsMutexUnlock(pintr->mutex);
+        }
+    }
+
+    if (intr_stat_mutex) {
+        epicsMutexMustLock(intr_stat_mutex);
+        intr_errors    = 0;
+        intr_unmatched = 0;
+        epicsMutexUnlock(intr_stat_mutex);
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 //
 // Register iocsh command 'f3rp61GetModuleInfo'
@@ -421,7 +2449,7 @@ static void getModuleInfo(int verbosity)
                 .slotno = slot,
             };
 
-            ioctl(f3rp61_fd, M3IO_GET_MODULE_INFO, &module_info);
+            f3rp61_backend->ioctl(f3rp61_fd, M3IO_GET_MODULE_INFO, &module_info);
 
             if (!module_info.enable) {
                 if (!verbosity) {
@@ -459,6 +2487,19 @@ static void drvF3RP61RegisterCommands(void)
     iocshRegister(&getModuleInfoFuncDef, getModuleInfoCallFunc);
     iocshRegister(&comDeviceConfigureFuncDef, comDeviceConfigureCallFunc);
     iocshRegister(&linkDeviceConfigureFuncDef, linkDeviceConfigureCallFunc);
+    iocshRegister(&scanCacheConfigureFuncDef, scanCacheConfigureCallFunc);
+    iocshRegister(&outGroupConfigureFuncDef, outGroupConfigureCallFunc);
+    iocshRegister(&writeSuppressConfigureFuncDef, writeSuppressConfigureCallFunc);
+    iocshRegister(&readbackConfigureFuncDef, readbackConfigureCallFunc);
+    iocshRegister(&rampConfigureFuncDef, rampConfigureCallFunc);
+    iocshRegister(&interruptConfigureFuncDef, interruptConfigureCallFunc);
+    iocshRegister(&interruptStatsFuncDef, interruptStatsCallFunc);
+    iocshRegister(&interruptStatsResetFuncDef, interruptStatsResetCallFunc);
+
+    // Commands of the backend, e.g. those of the simulator on the host
+    if (f3rp61_backend->registerCommands) {
+        f3rp61_backend->registerCommands();
+    }
 }
 
 epicsExportRegistrar(drvF3RP61RegisterCommands);
@@ -1,17 +1,128 @@
 #ifndef DRVF3RP61_H
 #define DRVF3RP61_H
 
+#include <stdint.h>
+
+#include <callback.h>
+#include <ellLib.h>
+#include <epicsTime.h>
+
 #if defined(__arm__)
 #  include <m3lib.h>
 #elif defined(__powerpc__)
 #  include <asm/fam3rtos/m3iodrv.h>
 #  include <asm/fam3rtos/m3lib.h>
 #else
-#  error
+#  include <drvF3RP61Sim.h>
 #endif
+#include <drvF3RP61Backend.h>
+
+// Snapshot of registers/relays on an I/O module, read once per scan
+// and shared by all the records on the same slot scanned at the same
+// period (see drvF3RP61.c)
+typedef struct F3RP61_SCAN_CACHE F3RP61_SCAN_CACHE;
+
+typedef struct {
+    F3RP61_SCAN_CACHE *pcache; // NULL when the record bypasses the cache
+    unsigned int generation;   // generation of the snapshot last read
+} F3RP61_SCAN_CACHE_REF;
+
+// Output relays of an I/O module written by a group of records with one
+// ioctl() (see drvF3RP61.c)
+typedef struct F3RP61_OUT_GROUP F3RP61_OUT_GROUP;
+
+typedef struct {
+    ELLNODE node;              // in the records waiting for the flush
+    F3RP61_OUT_GROUP *pgroup;  // NULL when the record bypasses the group
+    CALLBACK callback;         // to complete the record
+    int ret;                   // result of the flush
+} F3RP61_OUT_GROUP_REF;
+
+// Value last written by an output record with the &S option, to skip
+// writing the same value again (see drvF3RP61.c)
+typedef struct {
+    int enabled;
+    int valid;              // cleared until a write succeeds
+    int count;              // number of words
+    uint16_t wdata[4];
+    epicsUInt64 written;    // monotonic time of the last write, in ns
+} F3RP61_LAST_WRITE;
+
+// I/O registers of a special module staged by output records, and
+// written together by a commit record (see drvF3RP61.c)
+typedef struct F3RP61_STAGE F3RP61_STAGE;
+
+// Value of an ao record ramped towards its target by a thread of the
+// driver (see drvF3RP61.c)
+typedef struct F3RP61_RAMP F3RP61_RAMP;
+
+// Called for each output record found in the database, with the record
+// type and the OUT field
+typedef void (*F3RP61_OUTPUT_FUNC)(const char *, const char *, void *);
+
+// Interrupt channel of an I/O module which records are attached to
+// (see drvF3RP61.c)
+typedef struct F3RP61_IO_INTR_CHANNEL F3RP61_IO_INTR_CHANNEL;
+
+// Leading members of the DPVT of the records supporting I/O Intr scan,
+// read by f3rp61GetIoIntInfo()
+typedef struct {
+    IOSCANPVT ioscanpvt;
+    F3RP61_IO_INTR_CHANNEL *intr; // interrupt source, if any
+} F3RP61_IO_INTR_DPVT;
+
+// Latency histogram with logarithmic bins in microseconds: bin 0 for
+// less than 1 us, bin i for [2^(i-1), 2^i) us, and the last bin for
+// anything longer
+#define F3RP61_LATENCY_NBINS 24
+
+typedef struct {
+    unsigned long count;
+    double min;  // in microseconds
+    double max;  // in microseconds
+    double sum;  // in microseconds
+    unsigned long hist[F3RP61_LATENCY_NBINS];
+} F3RP61_LATENCY;
+
+// Statistics of an interrupt channel, or of all the channels with
+// errors and unmatched messages when read with unit of -1
+typedef struct {
+    unsigned long received;   // messages received
+    unsigned long overruns;   // interrupts while the records are busy
+    unsigned long errors;     // msgrcv() failures and broken messages
+    unsigned long unmatched;  // messages for no registered channel
+    F3RP61_LATENCY request;   // receipt to scanIoRequest()
+    F3RP61_LATENCY complete;  // receipt to completion of the records
+} F3RP61_IO_INTR_STAT;
+
+void f3rp61_latency_add(F3RP61_LATENCY *, double);
+double f3rp61_latency_mean(const F3RP61_LATENCY *);
+void f3rp61_latency_merge(F3RP61_LATENCY *, const F3RP61_LATENCY *);
 
 long f3rp61GetIoIntInfo(int, dbCommon *, IOSCANPVT *);
-long f3rp61_register_io_interrupt(dbCommon *, int, int, int);
+long f3rp61_register_io_interrupt(dbCommon *, int, int, int, F3RP61_IO_INTR_CHANNEL **);
+void f3rp61_set_io_interrupt_time(dbCommon *, F3RP61_IO_INTR_CHANNEL *);
+long f3rp61_get_io_interrupt_stat(int, int, int, F3RP61_IO_INTR_STAT *);
+long f3rp61_register_scan_cache(dbCommon *, F3RP61_SCAN_CACHE_REF *, char, int, int, int, int, int);
+long f3rp61_read_scan_cache(dbCommon *, F3RP61_SCAN_CACHE_REF *, int, int, uint16_t *);
+long f3rp61_register_out_group(dbCommon *, F3RP61_OUT_GROUP_REF *, int, int, int);
+long f3rp61_write_out_group(dbCommon *, F3RP61_OUT_GROUP_REF *, int, uint16_t, uint16_t);
+long f3rp61_register_out_group_flush(dbCommon *, F3RP61_OUT_GROUP **, int, int);
+long f3rp61_flush_out_group(F3RP61_OUT_GROUP *);
+int f3rp61_parse_suppress_option(char *);
+int f3rp61_is_write_unchanged(F3RP61_LAST_WRITE *, const uint16_t *, int);
+void f3rp61_set_last_write(F3RP61_LAST_WRITE *, const uint16_t *, int);
+int f3rp61_parse_staged_option(char *);
+long f3rp61_register_stage(dbCommon *, F3RP61_STAGE **, int, int, int, int);
+long f3rp61_write_stage(F3RP61_STAGE *, int, const uint16_t *, int);
+long f3rp61_commit_stage(F3RP61_STAGE *);
+int f3rp61_parse_ramp_option(char *, double *);
+long f3rp61_register_ramp(dbCommon *, F3RP61_RAMP **, char, int, int, int, char, double);
+void f3rp61_write_ramp(F3RP61_RAMP *, double);
+void f3rp61_set_ramp(F3RP61_RAMP *, double);
+void f3rp61_for_each_output(const char *, F3RP61_OUTPUT_FUNC, void *);
+int f3rp61_readback_enabled(void);
+long f3rp61_get_readback(char, int, int, int, int, uint16_t *);
 
 extern int f3rp61_fd;
 
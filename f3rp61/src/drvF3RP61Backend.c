@@ -0,0 +1,180 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* drvF3RP61Backend.c - Backend Selection and BSP Backend for F3RP61
+*
+*      Date: 2026 Oct. 16
+*/
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <drvF3RP61Backend.h>
+
+#if defined(__arm__) || defined(__powerpc__)
+
+//////////////////////////////////////////////////////////////////////////
+//
+// BSP backend
+//
+// The functions of the BSP are wrapped, so that the function table does
+// not depend on the exact prototypes in the headers of the BSP.
+//
+static int bsp_open(const char *path, int flags)
+{
+    return open(path, flags);
+}
+
+static int bsp_ioctl(int fd, unsigned long request, void *arg)
+{
+    return ioctl(fd, request, arg);
+}
+
+static int bsp_readM3ComRegister(int start, int count, unsigned short *data)
+{
+    return readM3ComRegister(start, count, data);
+}
+
+static int bsp_writeM3ComRegister(int start, int count, unsigned short *data)
+{
+    return writeM3ComRegister(start, count, data);
+}
+
+static int bsp_readM3ComRelay(int start, int count, unsigned short *data)
+{
+    return readM3ComRelay(start, count, data);
+}
+
+static int bsp_writeM3ComRelay(int start, int count, unsigned short *data)
+{
+    return writeM3ComRelay(start, count, data);
+}
+
+static int bsp_readM3ComRelayB(int start, int count, unsigned char *data)
+{
+    return readM3ComRelayB(start, count, data);
+}
+
+static int bsp_writeM3ComRelayB(int start, int count, unsigned char *data)
+{
+    return writeM3ComRelayB(start, count, data);
+}
+
+static int bsp_readM3LinkRegister(int start, int count, unsigned short *data)
+{
+    return readM3LinkRegister(start, count, data);
+}
+
+static int bsp_writeM3LinkRegister(int start, int count, unsigned short *data)
+{
+    return writeM3LinkRegister(start, count, data);
+}
+
+static int bsp_readM3LinkRelay(int start, int count, unsigned short *data)
+{
+    return readM3LinkRelay(start, count, data);
+}
+
+static int bsp_writeM3LinkRelay(int start, int count, unsigned short *data)
+{
+    return writeM3LinkRelay(start, count, data);
+}
+
+static int bsp_readM3LinkRelayB(int start, int count, unsigned char *data)
+{
+    return readM3LinkRelayB(start, count, data);
+}
+
+static int bsp_writeM3LinkRelayB(int start, int count, unsigned char *data)
+{
+    return writeM3LinkRelayB(start, count, data);
+}
+
+#if defined(__arm__)
+// Not available on F3RP61, which uses ioctl() instead
+static int bsp_readM3CpuMemory(int cpuno, int start, int count, unsigned short *data)
+{
+    return readM3CpuMemory(cpuno, start, count, data);
+}
+
+static int bsp_writeM3CpuMemory(int cpuno, int start, int count, unsigned short *data)
+{
+    return writeM3CpuMemory(cpuno, start, count, data);
+}
+
+static int bsp_readM3IoModeRegister(int unitno, int slotno, int start, int count, unsigned short *data)
+{
+    return readM3IoModeRegister(unitno, slotno, start, count, data);
+}
+
+static int bsp_writeM3IoModeRegister(int unitno, int slotno, int start, int count, unsigned short *data)
+{
+    return writeM3IoModeRegister(unitno, slotno, start, count, data);
+}
+#endif
+
+static int bsp_setM3ComDataConfig(M3COMDATACONFIG *pconfig, M3COMDATACONFIG *pext_config)
+{
+    return setM3ComDataConfig(pconfig, pext_config);
+}
+
+static int bsp_setM3LinkDeviceConfig(M3LINKDATACONFIG *pconfig)
+{
+    return setM3LinkDeviceConfig(pconfig);
+}
+
+static int bsp_setM3FlnSysNo(int sysno, void *parg)
+{
+    return setM3FlnSysNo(sysno, parg);
+}
+
+static int bsp_m3rfrsTsk(int period)
+{
+    return m3rfrsTsk(period);
+}
+
+static const F3RP61_BACKEND bsp_backend = {
+    .name                   = "BSP",
+    .open                   = bsp_open,
+    .ioctl                  = bsp_ioctl,
+    .readM3ComRegister      = bsp_readM3ComRegister,
+    .writeM3ComRegister     = bsp_writeM3ComRegister,
+    .readM3ComRelay         = bsp_readM3ComRelay,
+    .writeM3ComRelay        = bsp_writeM3ComRelay,
+    .readM3ComRelayB        = bsp_readM3ComRelayB,
+    .writeM3ComRelayB       = bsp_writeM3ComRelayB,
+    .readM3LinkRegister     = bsp_readM3LinkRegister,
+    .writeM3LinkRegister    = bsp_writeM3LinkRegister,
+    .readM3LinkRelay        = bsp_readM3LinkRelay,
+    .writeM3LinkRelay       = bsp_writeM3LinkRelay,
+    .readM3LinkRelayB       = bsp_readM3LinkRelayB,
+    .writeM3LinkRelayB      = bsp_writeM3LinkRelayB,
+#if defined(__arm__)
+    .readM3CpuMemory        = bsp_readM3CpuMemory,
+    .writeM3CpuMemory       = bsp_writeM3CpuMemory,
+    .readM3IoModeRegister   = bsp_readM3IoModeRegister,
+    .writeM3IoModeRegister  = bsp_writeM3IoModeRegister,
+#endif
+    .setM3ComDataConfig     = bsp_setM3ComDataConfig,
+    .setM3LinkDeviceConfig  = bsp_setM3LinkDeviceConfig,
+    .setM3FlnSysNo          = bsp_setM3FlnSysNo,
+    .m3rfrsTsk              = bsp_m3rfrsTsk,
+    .registerCommands       = NULL,
+};
+
+const F3RP61_BACKEND *f3rp61_backend = &bsp_backend;
+
+#else
+
+// Host builds run on the simulator
+const F3RP61_BACKEND *f3rp61_backend = &f3rp61_sim_backend;
+
+#endif
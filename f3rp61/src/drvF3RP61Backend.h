@@ -0,0 +1,63 @@
+#ifndef DRVF3RP61BACKEND_H
+#define DRVF3RP61BACKEND_H
+
+#if defined(__arm__)
+#  include <m3lib.h>
+#elif defined(__powerpc__)
+#  include <asm/fam3rtos/m3iodrv.h>
+#  include <asm/fam3rtos/m3lib.h>
+#else
+#  include <drvF3RP61Sim.h>
+#endif
+
+// Backend of the device / driver support
+//
+// All the accesses to the BSP, that is, the device files and the
+// functions of the M3 library, go through the function table of the
+// backend in use. The backend is the BSP itself on F3RP61/F3RP71, and
+// an in-memory simulator of I/O modules, shared/link devices, sequence
+// CPUs and interrupts on the host (see drvF3RP61Sim.c).
+typedef struct {
+    const char *name;
+
+    // Device files
+    int (*open)(const char *, int);
+    int (*ioctl)(int, unsigned long, void *);
+
+    // Shared devices, link devices and CPU memory
+    int (*readM3ComRegister)(int, int, unsigned short *);
+    int (*writeM3ComRegister)(int, int, unsigned short *);
+    int (*readM3ComRelay)(int, int, unsigned short *);
+    int (*writeM3ComRelay)(int, int, unsigned short *);
+    int (*readM3ComRelayB)(int, int, unsigned char *);
+    int (*writeM3ComRelayB)(int, int, unsigned char *);
+    int (*readM3LinkRegister)(int, int, unsigned short *);
+    int (*writeM3LinkRegister)(int, int, unsigned short *);
+    int (*readM3LinkRelay)(int, int, unsigned short *);
+    int (*writeM3LinkRelay)(int, int, unsigned short *);
+    int (*readM3LinkRelayB)(int, int, unsigned char *);
+    int (*writeM3LinkRelayB)(int, int, unsigned char *);
+    int (*readM3CpuMemory)(int, int, int, unsigned short *);
+    int (*writeM3CpuMemory)(int, int, int, unsigned short *);
+
+    // Mode registers of I/O modules
+    int (*readM3IoModeRegister)(int, int, int, int, unsigned short *);
+    int (*writeM3IoModeRegister)(int, int, int, int, unsigned short *);
+
+    // Configuration of shared devices and link devices
+    int (*setM3ComDataConfig)(M3COMDATACONFIG *, M3COMDATACONFIG *);
+    int (*setM3LinkDeviceConfig)(M3LINKDATACONFIG *);
+    int (*setM3FlnSysNo)(int, void *);
+    int (*m3rfrsTsk)(int);
+
+    // iocsh commands of the backend, if any
+    void (*registerCommands)(void);
+} F3RP61_BACKEND;
+
+extern const F3RP61_BACKEND *f3rp61_backend;
+
+#if !defined(__arm__) && !defined(__powerpc__)
+extern const F3RP61_BACKEND f3rp61_sim_backend;
+#endif
+
+#endif // DRVF3RP61BACKEND_H
@@ -13,6 +13,9 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,21 +25,26 @@
 #include <sys/msg.h>
 #include <unistd.h>
 
+#include <alarm.h>
 #include <callback.h>
+#include <cantProceed.h>
 #include <dbCommon.h>
 #include <dbScan.h>
 #include <drvSup.h>
+#include <epicsAtomic.h>
 #include <epicsEvent.h>
 #include <epicsExport.h>
 #include <epicsMutex.h>
 #include <epicsThread.h>
+#include <epicsTime.h>
 #include <errlog.h>
 #include <iocsh.h>
+#include <recGbl.h>
 #include <recSup.h>
 
 #include <drvF3RP61Seq.h>
 
-static long report();
+static long report(int);
 static long init();
 
 struct {
@@ -53,25 +61,210 @@ epicsExportAddress(drvet, drvF3RP61Seq);
 
 int f3rp61Seq_fd = -1;
 
-void showreq(const iocshArgBuf *);
-void stopshow(const iocshArgBuf *);
-static const iocshFuncDef showreqDef = {"showreq", 0, NULL};
-static const iocshFuncDef stopshowDef = {"stopshow", 0, NULL};
+static int com_id; // incremented atomically for every command
 
-static int debug_flag;
-static unsigned short request_id;
+// Requests are served by a worker for each sequence CPU, so that CPUs
+// in different slots are accessed in parallel. A worker may have more
+// than one request in flight, when the BSP allows it. Records push
+// their requests into the inbox of the worker without taking a lock,
+// and the worker moves them all into its queue in one pass.
+#define F3RP61_SEQ_NUM_SLOTS     16
+#define F3RP61_SEQ_MAX_PIPELINE  8 // threads of a worker
 
-static void mcmd_thread(void *);
-static void dump_mcmd_request(MCMD_STRUCT *);
-static epicsMutexId f3rp61Seq_queueMutex;
-static epicsEventId f3rp61Seq_queueEvent;
-static ELLLIST f3rp61Seq_queueList;
+typedef struct {
+    int          slot;
+    epicsMutexId mutex;
+    epicsEventId event;
+    void        *inbox;          // requests pushed without lock, latest first
+    ELLLIST      queue;          // requests taken from the inbox, in order
+    int          inflight;       // requests taken and not completed yet
+    int          inflight_write; // whether a write is in flight
+    unsigned long commands;
+    unsigned long read_requests;
+    unsigned long read_commands;
+    unsigned long read_attached;  // reads served by identical ones queued
+    unsigned long errors;
+    int           queued;         // requests waiting for commands, atomic
+    int           queued_max;     // high-water mark of queued, atomic
+    F3RP61_LATENCY wait;          // queueing to the start of the command
+    F3RP61_LATENCY service;       // the command in ioctl()
+    epicsUInt64   rate_time;      // monotonic time the rate was last updated, in ns
+    unsigned long rate_requests;  // requests completed by then
+    double        rate;           // requests completed per second
+} F3RP61_SEQ_WORKER;
+
+static epicsMutexId workers_mutex;
+static F3RP61_SEQ_WORKER *workers[F3RP61_SEQ_NUM_SLOTS + 1];
+static int pipeline_depth = 1;
+static int workers_started;
+
+// Requests are queued in order of the priority of their records, and
+// writes may be boosted by one level over the records' own priority
+static int boost_writes;
+
+// Coalescing of read requests to contiguous devices
+#define F3RP61_SEQ_MAX_COALESCE 256 // words in a single read command
+
+static int coalesce_max = 64; // words in a merged read, 1 disables coalescing
+
+// Ranges of devices polled in bulk by a thread into images, from which
+// records in the cached mode read synchronously
+struct F3RP61_SEQ_POLL {
+    ELLNODE        node;
+    int            slot;
+    char           device;
+    int            devType;
+    int            accessType;
+    long           top;
+    int            count;
+    double         period;
+    double         max_age;   // of the image for records to read it
+    epicsUInt64    next;      // monotonic time to poll next, in ns
+    uint16_t      *buf;       // read into by the poll thread only
+    int            failing;   // reported the failure already
+    epicsMutexId   mutex;
+    uint16_t      *image;
+    epicsUInt64    updated;   // monotonic time of the last update, in ns
+    epicsTimeStamp time;      // of the last update, for TSE=-2
+    int            valid;
+    unsigned long  updates;
+    unsigned long  errors;
+};
 
-static F3RP61_SEQ_DPVT *get_request_from_queue(void);
+static ELLLIST poll_list;
+static int poll_started;
+
+// Devices written by output records, read at iocInit when the readback
+// is enabled (see f3rp61ReadbackConfigure), merged as the reads are
+typedef struct {
+    ELLNODE   node;
+    int       slot;
+    char      device;
+    int       devType;
+    int       accessType;
+    long      top;
+    int       count;
+    uint16_t *wData;
+    int       valid;
+} F3RP61_SEQ_READBACK;
+
+static ELLLIST readback_list;
+
+// Trace of the commands issued, kept in a ring written without lock.
+// An entry is numbered when written, and read only if the number is the
+// same before and after copying it.
+#define F3RP61_SEQ_TRACE_SIZE 1024 // entries, a power of 2
+
+typedef struct {
+    size_t         seq;        // number of the entry + 1, 0 while written
+    unsigned short comId;
+    unsigned short slot;
+    unsigned short subCode;
+    unsigned short accessType;
+    unsigned short devType;
+    unsigned short dataNum;
+    long           topDevNo;
+    int            requests;   // served by the command, 0 by the poll thread
+    int            ret;
+    unsigned short errorCode;
+    epicsTimeStamp queued;     // the earliest of the requests
+    epicsTimeStamp start;      // of ioctl()
+    epicsTimeStamp end;        // of ioctl()
+    epicsTimeStamp completed;  // when the records are requested to process
+} F3RP61_SEQ_TRACE;
+
+static F3RP61_SEQ_TRACE trace_ring[F3RP61_SEQ_TRACE_SIZE];
+static size_t trace_next; // number of the entries ever written, wraps around
+static int trace_enabled;
+
+static void mcmd_thread(void *);
+static void trace_command(const MCMD_STRUCT *, int, int, const epicsTimeStamp *,
+                          const epicsTimeStamp *, const epicsTimeStamp *);
+static int trace_get(size_t, F3RP61_SEQ_TRACE *);
+static F3RP61_SEQ_WORKER *get_worker(int);
+static int get_requests_from_queue(F3RP61_SEQ_WORKER *, ELLLIST *);
+static void finish_requests(F3RP61_SEQ_WORKER *, int, int, int);
+static int is_read_request(const F3RP61_SEQ_DPVT *);
+static int is_same_read(const F3RP61_SEQ_DPVT *, const F3RP61_SEQ_DPVT *);
+static void take_requests_from_inbox(F3RP61_SEQ_WORKER *);
+static void insert_request(F3RP61_SEQ_WORKER *, F3RP61_SEQ_DPVT *);
+static void compose_command(const F3RP61_SEQ_ADDR *, MCMD_STRUCT *);
+static void issue_request(F3RP61_SEQ_WORKER *, F3RP61_SEQ_DPVT *, MCMD_STRUCT *);
+static int issue_merged_read(F3RP61_SEQ_WORKER *, ELLLIST *, MCMD_STRUCT *);
+static void account_command(F3RP61_SEQ_WORKER *, F3RP61_SEQ_DPVT *, int, int,
+                            epicsUInt64, epicsUInt64);
+static unsigned long requests_completed(const F3RP61_SEQ_WORKER *);
+static void update_rate(F3RP61_SEQ_WORKER *, epicsUInt64);
+static void complete_request(F3RP61_SEQ_DPVT *);
+static void seqCoalesceCallFunc(const iocshArgBuf *);
+static void seqPipelineCallFunc(const iocshArgBuf *);
+static void seqPriorityCallFunc(const iocshArgBuf *);
+static void seqPollCallFunc(const iocshArgBuf *);
+static void seqTraceCallFunc(const iocshArgBuf *);
+static void seqTraceShowCallFunc(const iocshArgBuf *);
+static void seqTraceSaveCallFunc(const iocshArgBuf *);
+static void poll_thread(void *);
+static int poll_range(F3RP61_SEQ_POLL *, int, MCMD_STRUCT *);
+static int read_devices(int, int, char, int, int, long, int, MCMD_STRUCT *, uint16_t *, int);
+static void find_readback(const char *, const char *, void *);
+static void take_readbacks(void);
+static void drvF3RP61SeqRegisterCommands(void);
 
 //
-static long report(void)
+static long report(int level)
 {
+    if (level < 1) {
+        return 0;
+    }
+
+    printf("Read coalescing: %s (up to %d words)\n", (coalesce_max > 1) ? "enabled" : "disabled", coalesce_max);
+    printf("Requests in flight: up to %d per CPU\n", pipeline_depth);
+    printf("Writes boosted: %s\n", boost_writes ? "yes" : "no");
+
+    const epicsUInt64 now = epicsMonotonicGet();
+    for (int slot = 1; slot <= F3RP61_SEQ_NUM_SLOTS; slot++) {
+        F3RP61_SEQ_WORKER *worker = workers[slot];
+        if (!worker) {
+            continue;
+        }
+        epicsMutexMustLock(worker->mutex);
+        update_rate(worker, now);
+        printf("  CPU%d: %lu commands, %lu read requests in %lu commands, %lu attached, %lu errors\n",
+               slot, worker->commands, worker->read_requests, worker->read_commands,
+               worker->read_attached, worker->errors);
+        printf("    %.1f requests/s, %d queued (%d at most)\n", worker->rate,
+               epicsAtomicGetIntT(&worker->queued), epicsAtomicGetIntT(&worker->queued_max));
+        printf("    wait     min=%.1f mean=%.1f max=%.1f (us)\n",
+               worker->wait.min, f3rp61_latency_mean(&worker->wait), worker->wait.max);
+        printf("    service  min=%.1f mean=%.1f max=%.1f (us)\n",
+               worker->service.min, f3rp61_latency_mean(&worker->service), worker->service.max);
+        epicsMutexUnlock(worker->mutex);
+    }
+
+    for (F3RP61_SEQ_READBACK *preadback = (F3RP61_SEQ_READBACK *) ellFirst(&readback_list);
+         preadback;
+         preadback = (F3RP61_SEQ_READBACK *) ellNext(&preadback->node)) {
+        printf("  CPU%d,%c%ld (%d %s) %s\n",
+               preadback->slot, preadback->device, preadback->top, preadback->count,
+               (preadback->accessType == kBit) ? "bits" : "words",
+               preadback->valid ? "read back" : "not read back");
+    }
+
+    for (F3RP61_SEQ_POLL *ppoll = (F3RP61_SEQ_POLL *) ellFirst(&poll_list);
+         ppoll;
+         ppoll = (F3RP61_SEQ_POLL *) ellNext(&ppoll->node)) {
+        epicsMutexMustLock(ppoll->mutex);
+        printf("  CPU%d,%c%ld (%d %s) every %g s: %lu updates, %lu errors",
+               ppoll->slot, ppoll->device, ppoll->top, ppoll->count,
+               (ppoll->accessType == kBit) ? "bits" : "words", ppoll->period,
+               ppoll->updates, ppoll->errors);
+        if (ppoll->valid) {
+            printf(", age %.3f s", (epicsMonotonicGet() - ppoll->updated) * 1e-9);
+        }
+        printf("\n");
+        epicsMutexUnlock(ppoll->mutex);
+    }
+
     return 0;
 }
 
@@ -84,131 +277,1358 @@ static long init(void)
     }
     init_flag = 1;
 
-    f3rp61Seq_fd = open(DEVFILE, O_RDWR);
+    f3rp61Seq_fd = f3rp61_backend->open(DEVFILE, O_RDWR);
     if (f3rp61Seq_fd < 0) {
         errlogPrintf("drvF3RP61Seq: can't open " DEVFILE "\n");
         return -1;
     }
 
-    f3rp61Seq_queueMutex = epicsMutexCreate();
-    if (f3rp61Seq_queueMutex == 0) {
+    workers_mutex = epicsMutexCreate();
+    if (workers_mutex == 0) {
         errlogPrintf("drvF3RP61Seq: epicsMutexCreate failed\n");
         return -1;
     }
 
-    f3rp61Seq_queueEvent = epicsEventCreate(epicsEventEmpty);
-    if (f3rp61Seq_queueEvent == 0) {
-        errlogPrintf("drvF3RP61Seq: epicsEventCreate failed\n");
+    if (ellCount(&poll_list) > 0) {
+        if (epicsThreadCreate("f3rp61Seq_poll",
+                              epicsThreadPriorityHigh,
+                              epicsThreadGetStackSize(epicsThreadStackSmall),
+                              (EPICSTHREADFUNC) poll_thread,
+                              NULL) == 0) {
+            errlogPrintf("drvF3RP61Seq: epicsThreadCreate failed\n");
+            return -1;
+        }
+    }
+    poll_started = 1;
+
+    if (f3rp61_readback_enabled()) {
+        f3rp61_for_each_output("F3RP61Seq", find_readback, NULL);
+        take_readbacks();
+    }
+
+    return 0;
+}
+
+// Get the worker for the sequence CPU in the slot, which is started on
+// the first request to the CPU. The lock is taken only then.
+static F3RP61_SEQ_WORKER *get_worker(int slot)
+{
+    if (slot < 1 || slot > F3RP61_SEQ_NUM_SLOTS) {
+        errlogPrintf("drvF3RP61Seq: invalid slot %d\n", slot);
+        return NULL;
+    }
+
+    F3RP61_SEQ_WORKER *started = epicsAtomicGetPtrT((void **) &workers[slot]);
+    if (started) {
+        return started;
+    }
+
+    epicsMutexMustLock(workers_mutex);
+    F3RP61_SEQ_WORKER *worker = workers[slot];
+    if (!worker) {
+        worker = callocMustSucceed(1, sizeof(F3RP61_SEQ_WORKER), "calloc failed");
+        worker->slot  = slot;
+        worker->mutex = epicsMutexMustCreate();
+        worker->event = epicsEventMustCreate(epicsEventEmpty);
+        ellInit(&worker->queue);
+
+        for (int i = 0; i < pipeline_depth; i++) {
+            char name[32];
+            if (pipeline_depth > 1) {
+                snprintf(name, sizeof(name), "f3rp61Seq_cpu%d_%d", slot, i);
+            } else {
+                snprintf(name, sizeof(name), "f3rp61Seq_cpu%d", slot);
+            }
+            if (epicsThreadCreate(name,
+                                  epicsThreadPriorityHigh,
+                                  epicsThreadGetStackSize(epicsThreadStackSmall),
+                                  (EPICSTHREADFUNC) mcmd_thread,
+                                  worker) == 0) {
+                errlogPrintf("drvF3RP61Seq: epicsThreadCreate failed\n");
+                if (i == 0) {
+                    epicsMutexUnlock(workers_mutex);
+                    return NULL;
+                }
+                break;
+            }
+        }
+
+        epicsAtomicSetPtrT((void **) &workers[slot], worker);
+        workers_started = 1;
+    }
+    epicsMutexUnlock(workers_mutex);
+
+    return worker;
+}
+
+//
+static void mcmd_thread(void *arg)
+{
+    F3RP61_SEQ_WORKER *worker = arg;
+
+    // Requests hold only the devices to access, and the commands are
+    // composed in the buffer of the thread, one at a time
+    MCMD_STRUCT *pmcmd = callocMustSucceed(1, sizeof(MCMD_STRUCT), "calloc failed");
+
+    for (;;) {
+        epicsEventMustWait(worker->event);
+
+        ELLLIST batch;
+        while (get_requests_from_queue(worker, &batch) > 0) {
+            F3RP61_SEQ_DPVT *dpvt = (F3RP61_SEQ_DPVT *) ellFirst(&batch);
+            const int read = is_read_request(dpvt);
+            const int count = ellCount(&batch);
+
+            // Let another thread of the worker take the next requests
+            if (pipeline_depth > 1) {
+                epicsEventSignal(worker->event);
+            }
+
+            int commands = 1;
+            if (count == 1) {
+                ellGet(&batch);
+                issue_request(worker, dpvt, pmcmd);
+            } else {
+                commands = issue_merged_read(worker, &batch, pmcmd);
+            }
+
+            finish_requests(worker, read, count, commands);
+        }
+    }
+}
+
+// Compose the message command to access the devices
+static void compose_command(const F3RP61_SEQ_ADDR *paddr, MCMD_STRUCT *pmcmdStruct)
+{
+    memset(&pmcmdStruct->mcmdRequest, 0, offsetof(MCMD_REQUEST, dataBuff));
+    pmcmdStruct->timeOut = 1;
+
+    MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
+    pmcmdRequest->formatCode = 0xf1;
+    pmcmdRequest->responseOption = 1;
+    pmcmdRequest->srcSlot = paddr->srcSlot;
+    pmcmdRequest->destSlot = paddr->destSlot;
+    pmcmdRequest->mainCode = 0x26;
+    pmcmdRequest->subCode = paddr->subCode;
+
+    // The header of M3_WRITE_SEQDEV is the same as M3_READ_SEQDEV
+    M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
+    pM3WriteSeqdev->accessType = paddr->accessType;
+    pM3WriteSeqdev->devType = paddr->devType;
+    pM3WriteSeqdev->topDevNo = paddr->topDevNo;
+    pM3WriteSeqdev->dataNum = paddr->dataNum;
+
+    if (paddr->subCode == 0x01) {
+        pmcmdRequest->dataSize = 10;
+    } else {
+        pmcmdRequest->dataSize = 10 + 2 * paddr->dataNum;
+    }
+}
+
+// Issue a request as is, and complete it
+static void issue_request(F3RP61_SEQ_WORKER *worker, F3RP61_SEQ_DPVT *dpvt, MCMD_STRUCT *pmcmdStruct)
+{
+    const F3RP61_SEQ_ADDR *paddr = &dpvt->addr;
+    compose_command(paddr, pmcmdStruct);
+    if (!is_read_request(dpvt)) {
+        M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdStruct->mcmdRequest.dataBuff.bData[0];
+        memcpy(&pM3WriteSeqdev->dataBuff.wData[0], &dpvt->wData[0], paddr->dataNum * sizeof(uint16_t));
+    }
+
+    dpvt->ret = 0;
+    const unsigned short id = (unsigned short) epicsAtomicIncrIntT(&com_id);
+    pmcmdStruct->mcmdRequest.comId = id;
+
+    const int trace = trace_enabled;
+    const epicsTimeStamp queued = dpvt->queued;
+    epicsTimeStamp start, end;
+    epicsTimeGetCurrent(&start);
+    const epicsUInt64 start_at = epicsMonotonicGet();
+
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_ACCS_CMD, pmcmdStruct) < 0) {
+        errlogPrintf("drvF3RP61Seq: ioctl failed [%d] : %s\n", errno, strerror(errno));
+        dpvt->ret = -1;
+    }
+
+    const epicsUInt64 end_at = epicsMonotonicGet();
+    epicsTimeGetCurrent(&end);
+
+    if (pmcmdStruct->mcmdResponse.comId != id) {
+        errlogPrintf("drvF3RP61Seq: comId does not match\n");
+        dpvt->ret = -1;
+    }
+
+    const int ret = dpvt->ret;
+    dpvt->errorCode = pmcmdStruct->mcmdResponse.errorCode;
+    if (is_read_request(dpvt)) {
+        memcpy(&dpvt->wData[0], &pmcmdStruct->mcmdResponse.dataBuff.wData[0], paddr->dataNum * sizeof(uint16_t));
+    }
+
+    account_command(worker, dpvt, 1, ret < 0 || dpvt->errorCode, start_at, end_at);
+    complete_request(dpvt);
+
+    if (trace) {
+        trace_command(pmcmdStruct, 1, ret, &queued, &start, &end);
+    }
+}
+
+// Issue a single read command covering all the read requests in the
+// batch, and scatter the words of the response to the requests. Should
+// the command fail, the requests are issued one by one, so that each of
+// them gets the status of its own devices. Returns the number of
+// commands issued.
+static int issue_merged_read(F3RP61_SEQ_WORKER *worker, ELLLIST *pbatch, MCMD_STRUCT *pmerged)
+{
+    F3RP61_SEQ_DPVT *dpvt = (F3RP61_SEQ_DPVT *) ellFirst(pbatch);
+    long top = LONG_MAX, end = 0;
+    for (; dpvt; dpvt = (F3RP61_SEQ_DPVT *) ellNext(&dpvt->node)) {
+        const F3RP61_SEQ_ADDR *paddr = &dpvt->addr;
+        if (paddr->topDevNo < top) {
+            top = paddr->topDevNo;
+        }
+        if (paddr->topDevNo + paddr->dataNum > end) {
+            end = paddr->topDevNo + paddr->dataNum;
+        }
+    }
+
+    // The first request gives the rest of the command
+    dpvt = (F3RP61_SEQ_DPVT *) ellFirst(pbatch);
+    F3RP61_SEQ_ADDR merged = dpvt->addr;
+    merged.topDevNo = top;
+    merged.dataNum  = end - top;
+    compose_command(&merged, pmerged);
+
+    int ret = 0;
+    const unsigned short id = (unsigned short) epicsAtomicIncrIntT(&com_id);
+    pmerged->mcmdRequest.comId = id;
+
+    const int trace = trace_enabled;
+    const int count = ellCount(pbatch);
+    epicsTimeStamp queued = dpvt->queued;
+    for (F3RP61_SEQ_DPVT *pnext = dpvt; pnext; pnext = (F3RP61_SEQ_DPVT *) ellNext(&pnext->node)) {
+        if (epicsTimeLessThan(&pnext->queued, &queued)) {
+            queued = pnext->queued;
+        }
+    }
+
+    epicsTimeStamp start, finish;
+    epicsTimeGetCurrent(&start);
+    const epicsUInt64 start_at = epicsMonotonicGet();
+
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_ACCS_CMD, pmerged) < 0) {
+        errlogPrintf("drvF3RP61Seq: ioctl failed [%d] : %s\n", errno, strerror(errno));
+        ret = -1;
+    }
+
+    const epicsUInt64 finish_at = epicsMonotonicGet();
+    epicsTimeGetCurrent(&finish);
+
+    if (pmerged->mcmdResponse.comId != id) {
+        errlogPrintf("drvF3RP61Seq: comId does not match\n");
+        ret = -1;
+    }
+
+    const int failed = (ret < 0 || pmerged->mcmdResponse.errorCode);
+
+    // The requests are accounted for when issued again
+    account_command(worker, (F3RP61_SEQ_DPVT *) ellFirst(pbatch), failed ? 0 : count,
+                    failed, start_at, finish_at);
+
+    if (trace) {
+        trace_command(pmerged, count, ret, &queued, &start, &finish);
+    }
+
+    if (failed) {
+        while ((dpvt = (F3RP61_SEQ_DPVT *) ellGet(pbatch))) {
+            issue_request(worker, dpvt, pmerged);
+        }
+        return 1 + count;
+    }
+
+    while ((dpvt = (F3RP61_SEQ_DPVT *) ellGet(pbatch))) {
+        const F3RP61_SEQ_ADDR *paddr = &dpvt->addr;
+
+        dpvt->ret = 0;
+        dpvt->errorCode = 0;
+        memcpy(&dpvt->wData[0],
+               &pmerged->mcmdResponse.dataBuff.wData[paddr->topDevNo - top],
+               paddr->dataNum * sizeof(uint16_t));
+
+        complete_request(dpvt);
+    }
+
+    return 1;
+}
+
+// Account for a command issued for count requests, from the first one
+// in a batch, before the requests are completed. The command is timed on
+// the monotonic clock, so that the statistics are not disturbed by any
+// adjustment of the wall clock.
+static void account_command(F3RP61_SEQ_WORKER *worker, F3RP61_SEQ_DPVT *dpvt, int count, int failed,
+                            epicsUInt64 start, epicsUInt64 end)
+{
+    epicsMutexMustLock(worker->mutex);
+    for (int i = 0; i < count && dpvt; i++) {
+        f3rp61_latency_add(&worker->wait, (start - dpvt->queued_at) * 1e-3);
+        dpvt = (F3RP61_SEQ_DPVT *) ellNext(&dpvt->node);
+    }
+    f3rp61_latency_add(&worker->service, (end - start) * 1e-3);
+    if (failed) {
+        worker->errors++;
+    }
+    epicsMutexUnlock(worker->mutex);
+}
+
+// Process the record of the request (the second call) at the priority
+// of the record, along with the records of the reads attached to it,
+// which get the same response
+static void complete_request(F3RP61_SEQ_DPVT *dpvt)
+{
+    // The responses are copied before any record is processed, as the
+    // request may be queued again on processing
+    ELLLIST waiters = dpvt->waiters;
+    ellInit(&dpvt->waiters);
+    for (F3RP61_SEQ_DPVT *pwaiter = (F3RP61_SEQ_DPVT *) ellFirst(&waiters);
+         pwaiter;
+         pwaiter = (F3RP61_SEQ_DPVT *) ellNext(&pwaiter->node)) {
+        pwaiter->ret = dpvt->ret;
+        pwaiter->errorCode = dpvt->errorCode;
+        memcpy(&pwaiter->wData[0], &dpvt->wData[0], dpvt->addr.dataNum * sizeof(uint16_t));
+    }
+
+    F3RP61_SEQ_DPVT *pwaiter;
+    while ((pwaiter = (F3RP61_SEQ_DPVT *) ellGet(&waiters))) {
+        CALLBACK *pcallback = &pwaiter->callback;
+        dbCommon *prec;
+        callbackGetUser(prec, pcallback);
+        const int priority = (prec->prio < NUM_CALLBACK_PRIORITIES) ? prec->prio : priorityHigh;
+        callbackRequestProcessCallback(pcallback, priority, prec);
+    }
+
+    CALLBACK *pcallback = &dpvt->callback;
+    dbCommon *prec;
+    callbackGetUser(prec, pcallback);
+    const int priority = (prec->prio < NUM_CALLBACK_PRIORITIES) ? prec->prio : priorityHigh;
+    callbackRequestProcessCallback(pcallback, priority, prec);
+}
+
+//
+int f3rp61Seq_queueRequest(F3RP61_SEQ_DPVT *dpvt)
+{
+    if (!dpvt) {
+        errlogPrintf("drvF3RP61Seq: null request\n");
         return -1;
     }
 
-    ellInit(&f3rp61Seq_queueList);
+    F3RP61_SEQ_WORKER *worker = get_worker(dpvt->addr.destSlot);
+    if (!worker) {
+        return -1;
+    }
+
+    CALLBACK *pcallback = &dpvt->callback;
+    dbCommon *prec;
+    callbackGetUser(prec, pcallback);
+    dpvt->priority = prec->prio;
+    if (boost_writes && !is_read_request(dpvt)) {
+        dpvt->priority++;
+    }
+
+    epicsTimeGetCurrent(&dpvt->queued);
+    dpvt->queued_at = epicsMonotonicGet();
+
+    // Requests waiting for commands, and the high-water mark
+    const int queued = epicsAtomicIncrIntT(&worker->queued);
+    int queued_max;
+    while (queued > (queued_max = epicsAtomicGetIntT(&worker->queued_max)) &&
+           epicsAtomicCmpAndSwapIntT(&worker->queued_max, queued_max, queued) != queued_max) {
+    }
+
+    // Push onto the inbox, waking the worker only if it was empty, as the
+    // worker takes everything in the inbox once woken
+    void *head;
+    do {
+        head = epicsAtomicGetPtrT(&worker->inbox);
+        dpvt->inbox_next = head;
+    } while (epicsAtomicCmpAndSwapPtrT(&worker->inbox, head, dpvt) != head);
+
+    if (!head) {
+        epicsEventSignal(worker->event);
+    }
+
+    return 0;
+}
+
+// Move all the requests in the inbox into the queue, in the order they
+// were pushed. Called with the mutex of the worker locked.
+static void take_requests_from_inbox(F3RP61_SEQ_WORKER *worker)
+{
+    void *head;
+    do {
+        head = epicsAtomicGetPtrT(&worker->inbox);
+    } while (head && epicsAtomicCmpAndSwapPtrT(&worker->inbox, head, NULL) != head);
+
+    // The inbox is latest first
+    F3RP61_SEQ_DPVT *first = NULL;
+    while (head) {
+        F3RP61_SEQ_DPVT *dpvt = head;
+        head = dpvt->inbox_next;
+        dpvt->inbox_next = first;
+        first = dpvt;
+    }
+
+    while (first) {
+        F3RP61_SEQ_DPVT *dpvt = first;
+        first = dpvt->inbox_next;
+        dpvt->inbox_next = NULL;
+        insert_request(worker, dpvt);
+    }
+}
+
+// Insert a request into the queue behind the requests of the same or
+// higher priority. Called with the mutex of the worker locked.
+static void insert_request(F3RP61_SEQ_WORKER *worker, F3RP61_SEQ_DPVT *dpvt)
+{
+    F3RP61_SEQ_DPVT *prev = (F3RP61_SEQ_DPVT *) ellLast(&worker->queue);
+    while (prev && prev->priority < dpvt->priority) {
+        prev = (F3RP61_SEQ_DPVT *) ellPrevious(&prev->node);
+    }
+
+    // A read is attached to an identical one to be issued before it,
+    // unless a write comes in between, and completed with its response
+    if (is_read_request(dpvt)) {
+        for (F3RP61_SEQ_DPVT *pqueued = prev;
+             pqueued && is_read_request(pqueued);
+             pqueued = (F3RP61_SEQ_DPVT *) ellPrevious(&pqueued->node)) {
+            if (is_same_read(pqueued, dpvt)) {
+                ellAdd(&pqueued->waiters, &dpvt->node);
+                worker->read_attached++;
+                return;
+            }
+        }
+    }
 
-    if (epicsThreadCreate("f3rp61Seq_mcmd",
-                          epicsThreadPriorityHigh,
-                          epicsThreadGetStackSize(epicsThreadStackSmall),
-                          (EPICSTHREADFUNC) mcmd_thread,
-                          NULL) == 0) {
-        errlogPrintf("drvF3RP61Seq: epicsThreadCreate failed\n");
+    ellInsert(&worker->queue, prev ? &prev->node : NULL, &dpvt->node);
+}
+
+// Whether the request reads devices of a sequence CPU
+static int is_read_request(const F3RP61_SEQ_DPVT *dpvt)
+{
+    return dpvt->addr.subCode == 0x01;
+}
+
+// Whether two read requests read the same devices in the same way
+static int is_same_read(const F3RP61_SEQ_DPVT *dpvt1, const F3RP61_SEQ_DPVT *dpvt2)
+{
+    const F3RP61_SEQ_ADDR *pread1 = &dpvt1->addr;
+    const F3RP61_SEQ_ADDR *pread2 = &dpvt2->addr;
+
+    return pread1->destSlot == pread2->destSlot &&
+           pread1->accessType == pread2->accessType &&
+           pread1->devType == pread2->devType &&
+           pread1->topDevNo == pread2->topDevNo &&
+           pread1->dataNum == pread2->dataNum;
+}
+
+// Take the request at the head of the queue into the batch, along with
+// the queued read requests which can be merged into a single read
+// command with it. Those read the same type of devices in the same way,
+// adjacent to or overlapping the devices taken so that no device is read
+// needlessly, and the devices read by all of them span no more than
+// coalesce_max words. Requests queued after a write are left in the
+// queue.
+//
+// Requests are kept in order around writes: nothing is taken while a
+// write is in flight, and a write is not taken while other requests
+// are in flight. Returns the number of requests taken.
+static int get_requests_from_queue(F3RP61_SEQ_WORKER *worker, ELLLIST *pbatch)
+{
+    ellInit(pbatch);
+
+    epicsMutexMustLock(worker->mutex);
+    take_requests_from_inbox(worker);
+    F3RP61_SEQ_DPVT *head = (F3RP61_SEQ_DPVT *) ellFirst(&worker->queue);
+    if (!head || worker->inflight_write ||
+        (!is_read_request(head) && worker->inflight > 0)) {
+        epicsMutexUnlock(worker->mutex);
+        return 0;
+    }
+
+    ellDelete(&worker->queue, &head->node);
+    ellAdd(pbatch, &head->node);
+
+    if (!is_read_request(head)) {
+        worker->inflight_write = 1;
+
+    } else if (coalesce_max > 1) {
+        const F3RP61_SEQ_ADDR *phead = &head->addr;
+        long top = phead->topDevNo;
+        long end = phead->topDevNo + phead->dataNum;
+
+        // A request skipped may become adjacent with the ones taken after
+        // it, so the queue is scanned again as long as any is taken
+        int taken;
+        do {
+            taken = 0;
+            F3RP61_SEQ_DPVT *dpvt = (F3RP61_SEQ_DPVT *) ellFirst(&worker->queue);
+            while (dpvt) {
+                F3RP61_SEQ_DPVT *next = (F3RP61_SEQ_DPVT *) ellNext(&dpvt->node);
+                const F3RP61_SEQ_ADDR *pread = &dpvt->addr;
+                const long read_end = pread->topDevNo + pread->dataNum;
+                const long new_top = (pread->topDevNo < top) ? pread->topDevNo : top;
+                const long new_end = (read_end > end) ? read_end : end;
+
+                // Reads queued after a write to the CPU must see the result
+                if (!is_read_request(dpvt)) {
+                    break;
+                }
+
+                if (pread->devType == phead->devType &&
+                    pread->accessType == phead->accessType &&
+                    pread->topDevNo <= end && read_end >= top &&
+                    new_end - new_top <= coalesce_max) {
+                    ellDelete(&worker->queue, &dpvt->node);
+                    ellAdd(pbatch, &dpvt->node);
+                    top = new_top;
+                    end = new_end;
+                    taken = 1;
+                }
+                dpvt = next;
+            }
+        } while (taken);
+    }
+
+    worker->inflight++;
+    epicsMutexUnlock(worker->mutex);
+
+    // No longer waiting, along with the reads attached
+    int taken = 0;
+    for (F3RP61_SEQ_DPVT *dpvt = (F3RP61_SEQ_DPVT *) ellFirst(pbatch);
+         dpvt;
+         dpvt = (F3RP61_SEQ_DPVT *) ellNext(&dpvt->node)) {
+        taken += 1 + ellCount(&dpvt->waiters);
+    }
+    epicsAtomicAddIntT(&worker->queued, -taken);
+
+    return ellCount(pbatch);
+}
+
+// Account for the requests completed, and let the threads of the worker
+// take the requests held back by them
+static void finish_requests(F3RP61_SEQ_WORKER *worker, int read, int count, int commands)
+{
+    epicsMutexMustLock(worker->mutex);
+    worker->inflight--;
+    worker->commands += commands;
+    if (read) {
+        worker->read_requests += count;
+        worker->read_commands += commands;
+    } else {
+        worker->inflight_write = 0;
+    }
+    const int queued = ellCount(&worker->queue);
+    epicsMutexUnlock(worker->mutex);
+
+    if (queued > 0 && pipeline_depth > 1) {
+        epicsEventSignal(worker->event);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Statistics
+//
+// Requests completed by the worker, called with the mutex locked
+static unsigned long requests_completed(const F3RP61_SEQ_WORKER *worker)
+{
+    return worker->commands - worker->read_commands + worker->read_requests + worker->read_attached;
+}
+
+// Update the rate of the requests completed once a second at most,
+// called with the mutex locked
+static void update_rate(F3RP61_SEQ_WORKER *worker, epicsUInt64 now)
+{
+    const unsigned long requests = requests_completed(worker);
+
+    if (worker->rate_time == 0) {
+        worker->rate_time = now;
+        worker->rate_requests = requests;
+        return;
+    }
+
+    const double elapsed = (now - worker->rate_time) * 1e-9;
+    if (elapsed >= 1.0) {
+        worker->rate = (requests - worker->rate_requests) / elapsed;
+        worker->rate_time = now;
+        worker->rate_requests = requests;
+    }
+}
+
+// Get statistics of the requests to the sequence CPU in the slot, or
+// the sum over all the CPUs when slot is 0
+long f3rp61Seq_getStat(int slot, F3RP61_SEQ_STAT *pstat)
+{
+    memset(pstat, 0, sizeof(F3RP61_SEQ_STAT));
+
+    if (slot < 0 || slot > F3RP61_SEQ_NUM_SLOTS) {
         return -1;
     }
 
-    iocshRegister(&showreqDef, showreq);
-    iocshRegister(&stopshowDef, stopshow);
+    const epicsUInt64 now = epicsMonotonicGet();
+
+    const int first = slot ? slot : 1;
+    const int last  = slot ? slot : F3RP61_SEQ_NUM_SLOTS;
+    for (int i = first; i <= last; i++) {
+        F3RP61_SEQ_WORKER *worker = epicsAtomicGetPtrT((void **) &workers[i]);
+        if (!worker) {
+            continue;
+        }
+
+        epicsMutexMustLock(worker->mutex);
+        update_rate(worker, now);
+        pstat->requests   += requests_completed(worker);
+        pstat->commands   += worker->commands;
+        pstat->errors     += worker->errors;
+        pstat->rate       += worker->rate;
+        pstat->queued     += epicsAtomicGetIntT(&worker->queued);
+        pstat->queued_max += epicsAtomicGetIntT(&worker->queued_max);
+        f3rp61_latency_merge(&pstat->wait, &worker->wait);
+        f3rp61_latency_merge(&pstat->service, &worker->service);
+        epicsMutexUnlock(worker->mutex);
+    }
 
     return 0;
 }
 
+//////////////////////////////////////////////////////////////////////////
 //
-static void mcmd_thread(void *arg)
+// Cached mode
+//
+// Ranges of devices declared by f3rp61SeqPoll are read in bulk by the
+// poll thread into images, which records with the '&C' option read
+// synchronously instead of queueing requests. The poll thread issues
+// its commands by itself, besides the workers.
+//
+
+// Remove the '&C' option, which may come along with another option as
+// in "CPU1,D100&L&C", from the address. Returns whether it was given.
+int f3rp61Seq_parseCachedOption(char *buf)
+{
+    char *pcached = strstr(buf, "&C");
+    if (!pcached) {
+        return 0;
+    }
+
+    memmove(pcached, pcached + 2, strlen(pcached + 2) + 1);
+    return 1;
+}
+
+// Attach the request of a record in the cached mode to the polled range
+// which covers the devices read by the request
+long f3rp61Seq_attachPoll(F3RP61_SEQ_DPVT *dpvt)
+{
+    const F3RP61_SEQ_ADDR *pread = &dpvt->addr;
+
+    for (F3RP61_SEQ_POLL *ppoll = (F3RP61_SEQ_POLL *) ellFirst(&poll_list);
+         ppoll;
+         ppoll = (F3RP61_SEQ_POLL *) ellNext(&ppoll->node)) {
+        if (ppoll->slot == pread->destSlot &&
+            ppoll->devType == pread->devType &&
+            ppoll->accessType == pread->accessType &&
+            ppoll->top <= pread->topDevNo &&
+            pread->topDevNo + pread->dataNum <= ppoll->top + ppoll->count) {
+            dpvt->ppoll = ppoll;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+// Fill the response of the request from the polled image, as though the
+// request has been issued. The record is put in INVALID alarm if the
+// image is older than allowed.
+long f3rp61Seq_readPoll(dbCommon *prec, F3RP61_SEQ_DPVT *dpvt)
+{
+    F3RP61_SEQ_POLL *ppoll = dpvt->ppoll;
+    const F3RP61_SEQ_ADDR *pread = &dpvt->addr;
+
+    const epicsUInt64 now = epicsMonotonicGet();
+    epicsTimeStamp time;
+
+    epicsMutexMustLock(ppoll->mutex);
+    const int fresh = ppoll->valid && (now - ppoll->updated) * 1e-9 <= ppoll->max_age;
+    if (fresh) {
+        memcpy(&dpvt->wData[0], &ppoll->image[pread->topDevNo - ppoll->top],
+               pread->dataNum * sizeof(uint16_t));
+        time = ppoll->time;
+    }
+    epicsMutexUnlock(ppoll->mutex);
+
+    if (!fresh) {
+        recGblSetSevr(prec, TIMEOUT_ALARM, INVALID_ALARM);
+        return -1;
+    }
+
+    dpvt->ret = 0;
+    dpvt->errorCode = 0;
+
+    // Time stamp of the image when TSE is -2
+    if (prec->tse == epicsTimeEventDeviceTime) {
+        prec->time = time;
+    }
+
+    return 0;
+}
+
+//
+static void poll_thread(void *arg)
 {
+    MCMD_STRUCT *pmcmd = callocMustSucceed(1, sizeof(MCMD_STRUCT), "calloc failed");
+    int srcSlot = 0;
+
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
+        errlogPrintf("drvF3RP61Seq: ioctl failed [%d] : %s\n", errno, strerror(errno));
+        return;
+    }
+
+    // Scheduled on the monotonic clock, not to be disturbed by steps of
+    // the wall clock
+    epicsUInt64 now = epicsMonotonicGet();
+    for (F3RP61_SEQ_POLL *ppoll = (F3RP61_SEQ_POLL *) ellFirst(&poll_list);
+         ppoll;
+         ppoll = (F3RP61_SEQ_POLL *) ellNext(&ppoll->node)) {
+        ppoll->next = now;
+    }
+
     for (;;) {
-        epicsEventMustWait(f3rp61Seq_queueEvent);
+        double wait = 1.0;
+
+        now = epicsMonotonicGet();
+        for (F3RP61_SEQ_POLL *ppoll = (F3RP61_SEQ_POLL *) ellFirst(&poll_list);
+             ppoll;
+             ppoll = (F3RP61_SEQ_POLL *) ellNext(&ppoll->node)) {
+            if (ppoll->next <= now) {
+                const epicsUInt64 period = (epicsUInt64) (ppoll->period * 1e9);
+                const int ret = poll_range(ppoll, srcSlot, pmcmd);
+
+                epicsMutexMustLock(ppoll->mutex);
+                if (ret < 0) {
+                    ppoll->errors++;
+                } else {
+                    ppoll->updates++;
+                }
+                epicsMutexUnlock(ppoll->mutex);
 
-        F3RP61_SEQ_DPVT *dpvt;
-        while ((dpvt = get_request_from_queue())) {
-            dpvt->ret = 0;
-            MCMD_STRUCT *pmcmdStruct = &dpvt->mcmdStruct;
-            pmcmdStruct->mcmdRequest.comId = ++request_id;
+                // Report the failure only when it starts and ends, not
+                // at the rate of the poll
+                if (ret < 0 && !ppoll->failing) {
+                    errlogPrintf("drvF3RP61Seq: failed to poll CPU%d,%c%ld\n",
+                                 ppoll->slot, ppoll->device, ppoll->top);
+                    ppoll->failing = 1;
+                } else if (ret == 0 && ppoll->failing) {
+                    errlogPrintf("drvF3RP61Seq: polling CPU%d,%c%ld again\n",
+                                 ppoll->slot, ppoll->device, ppoll->top);
+                    ppoll->failing = 0;
+                }
 
-            if (debug_flag) {
-                dump_mcmd_request(pmcmdStruct);
+                // Skip the periods missed, if any
+                ppoll->next += period;
+                now = epicsMonotonicGet();
+                if (ppoll->next < now) {
+                    ppoll->next = now + period;
+                }
             }
 
-            if (ioctl(f3rp61Seq_fd, M3CPU_ACCS_CMD, pmcmdStruct) < 0) {
+            const double remaining = (ppoll->next > now) ? (ppoll->next - now) * 1e-9 : 0;
+            if (remaining < wait) {
+                wait = remaining;
+            }
+        }
+
+        if (wait > 0) {
+            epicsThreadSleep(wait);
+        }
+    }
+}
+
+// Read the devices of the range into its image, with as many commands
+// as necessary. The image is updated only when all of them succeed.
+static int poll_range(F3RP61_SEQ_POLL *ppoll, int srcSlot, MCMD_STRUCT *pmcmd)
+{
+    if (read_devices(srcSlot, ppoll->slot, ppoll->device, ppoll->accessType, ppoll->devType,
+                     ppoll->top, ppoll->count, pmcmd, ppoll->buf, !ppoll->failing) < 0) {
+        return -1;
+    }
+
+    epicsMutexMustLock(ppoll->mutex);
+    memcpy(ppoll->image, ppoll->buf, ppoll->count * sizeof(uint16_t));
+    ppoll->updated = epicsMonotonicGet();
+    epicsTimeGetCurrent(&ppoll->time);
+    ppoll->valid = 1;
+    epicsMutexUnlock(ppoll->mutex);
+
+    return 0;
+}
+
+// Read a range of devices synchronously, with as many commands as
+// necessary. The cause of a failure is logged if verbose.
+static int read_devices(int srcSlot, int slot, char device, int accessType, int devType,
+                        long top, int count, MCMD_STRUCT *pmcmd, uint16_t *buf,
+                        int verbose)
+{
+    for (int offset = 0; offset < count; offset += F3RP61_SEQ_MAX_COALESCE) {
+        const int num = (count - offset < F3RP61_SEQ_MAX_COALESCE) ?
+                         count - offset : F3RP61_SEQ_MAX_COALESCE;
+
+        const F3RP61_SEQ_ADDR addr = {
+            .srcSlot    = srcSlot,
+            .destSlot   = slot,
+            .subCode    = 0x01,
+            .accessType = accessType,
+            .devType    = devType,
+            .topDevNo   = top + offset,
+            .dataNum    = num,
+        };
+        compose_command(&addr, pmcmd);
+
+        const unsigned short id = (unsigned short) epicsAtomicIncrIntT(&com_id);
+        pmcmd->mcmdRequest.comId = id;
+
+        const int trace = trace_enabled;
+        epicsTimeStamp start, end;
+        if (trace) {
+            epicsTimeGetCurrent(&start);
+        }
+
+        const int ret = f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_ACCS_CMD, pmcmd);
+
+        if (trace) {
+            epicsTimeGetCurrent(&end);
+            trace_command(pmcmd, 0, ret, &start, &start, &end);
+        }
+
+        if (ret < 0) {
+            if (verbose) {
                 errlogPrintf("drvF3RP61Seq: ioctl failed [%d] : %s\n", errno, strerror(errno));
-                dpvt->ret = -1;
             }
+            return -1;
+        }
 
-            if (pmcmdStruct->mcmdResponse.comId != request_id) {
+        if (pmcmd->mcmdResponse.comId != id) {
+            if (verbose) {
                 errlogPrintf("drvF3RP61Seq: comId does not match\n");
-                dpvt->ret = -1;
             }
+            return -1;
+        }
 
-            CALLBACK *pcallback = &dpvt->callback;
-            dbCommon *prec;
-            callbackGetUser(prec, pcallback);
-            callbackRequestProcessCallback(pcallback, priorityLow, prec);
+        if (pmcmd->mcmdResponse.errorCode) {
+            if (verbose) {
+                errlogPrintf("drvF3RP61Seq: errorCode 0x%04x returned for CPU%d,%c%ld\n",
+                             pmcmd->mcmdResponse.errorCode, slot, device, top + offset);
+            }
+            return -1;
         }
+
+        memcpy(&buf[offset], &pmcmd->mcmdResponse.dataBuff.wData[0], num * sizeof(uint16_t));
     }
+
+    return 0;
 }
 
+//////////////////////////////////////////////////////////////////////////
 //
-int f3rp61Seq_queueRequest(F3RP61_SEQ_DPVT *dpvt)
+// Readback of output records at iocInit
+//
+// Add the devices written by an output record to the readback. The OUT
+// field is parsed as by the device supports, e.g. "@CPU2,D100&L".
+static void find_readback(const char *record_type, const char *out, void *arg)
 {
-    if (!dpvt) {
-        errlogPrintf("drvF3RP61Seq: null request\n");
-        return -1;
+    int slot = 0, top = 0;
+    char device = 0;
+    if (sscanf((out[0] == '@') ? &out[1] : out, "CPU%d,%c%d", &slot, &device, &top) < 3) {
+        return;
     }
 
-    epicsMutexMustLock(f3rp61Seq_queueMutex);
-    ellAdd(&f3rp61Seq_queueList, &dpvt->node);
-    epicsMutexUnlock(f3rp61Seq_queueMutex);
+    // Relays of bo records are written bit by bit, others word by word
+    const int accessType = strcmp(record_type, "bo") ? kWord : kBit;
+    int count = 1;
+    if (accessType == kWord) {
+        if (strstr(out, "&D")) {
+            count = 4;
+        } else if (strstr(out, "&L") || strstr(out, "&F")) {
+            count = 2;
+        }
+    }
 
-    epicsEventSignal(f3rp61Seq_queueEvent);
+    F3RP61_SEQ_READBACK *preadback;
+    for (preadback = (F3RP61_SEQ_READBACK *) ellFirst(&readback_list);
+         preadback;
+         preadback = (F3RP61_SEQ_READBACK *) ellNext(&preadback->node)) {
+        if (preadback->slot != slot || preadback->device != device || preadback->accessType != accessType) {
+            continue;
+        }
+
+        // Extend the range if the union still fits into a single command
+        const long first = (top < preadback->top) ? top : preadback->top;
+        const long last  = (top + count > preadback->top + preadback->count) ?
+                           (top + count) : (preadback->top + preadback->count);
+        if (last - first <= F3RP61_SEQ_MAX_COALESCE) {
+            preadback->top   = first;
+            preadback->count = last - first;
+            return;
+        }
+    }
+
+    preadback = callocMustSucceed(1, sizeof(F3RP61_SEQ_READBACK), "calloc failed");
+    preadback->slot       = slot;
+    preadback->device     = device;
+    preadback->devType    = device - '@';
+    preadback->accessType = accessType;
+    preadback->top        = top;
+    preadback->count      = count;
+    ellAdd(&readback_list, &preadback->node);
+}
 
+// Read all the devices to read back
+static void take_readbacks(void)
+{
+    int srcSlot = 0;
+    if (f3rp61_backend->ioctl(f3rp61Seq_fd, M3CPU_GET_NUM, &srcSlot) < 0) {
+        errlogPrintf("drvF3RP61Seq: ioctl failed [%d] : %s\n", errno, strerror(errno));
+        return;
+    }
+
+    MCMD_STRUCT *pmcmd = callocMustSucceed(1, sizeof(MCMD_STRUCT), "calloc failed");
+    for (F3RP61_SEQ_READBACK *preadback = (F3RP61_SEQ_READBACK *) ellFirst(&readback_list);
+         preadback;
+         preadback = (F3RP61_SEQ_READBACK *) ellNext(&preadback->node)) {
+        preadback->wData = callocMustSucceed(preadback->count, sizeof(uint16_t), "calloc failed");
+        if (read_devices(srcSlot, preadback->slot, preadback->device, preadback->accessType,
+                         preadback->devType, preadback->top, preadback->count, pmcmd, preadback->wData, 1) == 0) {
+            preadback->valid = 1;
+        }
+    }
+    free(pmcmd);
+}
+
+// Get the devices read back for an output record at iocInit. Returns -1
+// if they have not been read.
+long f3rp61Seq_getReadback(const F3RP61_SEQ_ADDR *paddr, uint16_t *wData)
+{
+    for (F3RP61_SEQ_READBACK *preadback = (F3RP61_SEQ_READBACK *) ellFirst(&readback_list);
+         preadback;
+         preadback = (F3RP61_SEQ_READBACK *) ellNext(&preadback->node)) {
+        if (preadback->valid && preadback->slot == paddr->destSlot &&
+            preadback->devType == paddr->devType && preadback->accessType == paddr->accessType &&
+            preadback->top <= paddr->topDevNo &&
+            paddr->topDevNo + paddr->dataNum <= preadback->top + preadback->count) {
+            memcpy(wData, &preadback->wData[paddr->topDevNo - preadback->top], paddr->dataNum * sizeof(uint16_t));
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Trace
+//
+// Add an entry for a command just completed to the trace ring
+static void trace_command(const MCMD_STRUCT *pmcmdStruct, int requests, int ret,
+                          const epicsTimeStamp *pqueued,
+                          const epicsTimeStamp *pstart,
+                          const epicsTimeStamp *pend)
+{
+    const MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
+    const M3_READ_SEQDEV *pM3ReadSeqdev = (M3_READ_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
+
+    const size_t n = epicsAtomicIncrSizeT(&trace_next) - 1;
+    F3RP61_SEQ_TRACE *ptrace = &trace_ring[n & (F3RP61_SEQ_TRACE_SIZE - 1)];
+
+    epicsAtomicSetSizeT(&ptrace->seq, 0);
+    epicsAtomicWriteMemoryBarrier();
+
+    ptrace->comId      = pmcmdRequest->comId;
+    ptrace->slot       = pmcmdRequest->destSlot;
+    ptrace->subCode    = pmcmdRequest->subCode;
+    ptrace->accessType = pM3ReadSeqdev->accessType;
+    ptrace->devType    = pM3ReadSeqdev->devType;
+    ptrace->dataNum    = pM3ReadSeqdev->dataNum;
+    ptrace->topDevNo   = pM3ReadSeqdev->topDevNo;
+    ptrace->requests   = requests;
+    ptrace->ret        = ret;
+    ptrace->errorCode  = pmcmdStruct->mcmdResponse.errorCode;
+    ptrace->queued     = *pqueued;
+    ptrace->start      = *pstart;
+    ptrace->end        = *pend;
+    epicsTimeGetCurrent(&ptrace->completed);
+
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetSizeT(&ptrace->seq, n + 1);
+}
+
+// Copy the n-th entry of the trace. Returns -1 if it is no longer in
+// the ring, never written, or being written. The numbers wrap around,
+// so an entry whose number + 1 is 0 is never shown.
+static int trace_get(size_t n, F3RP61_SEQ_TRACE *pcopy)
+{
+    const F3RP61_SEQ_TRACE *ptrace = &trace_ring[n & (F3RP61_SEQ_TRACE_SIZE - 1)];
+
+    const size_t seq = epicsAtomicGetSizeT(&ptrace->seq);
+    epicsAtomicReadMemoryBarrier();
+    *pcopy = *ptrace;
+    epicsAtomicReadMemoryBarrier();
+
+    if (seq == 0 || seq != n + 1 || epicsAtomicGetSizeT(&ptrace->seq) != seq) {
+        return -1;
+    }
     return 0;
 }
 
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SeqCoalesce'
+//
+// usage: f3rp61SeqCoalesce maxWords
 //
-static F3RP61_SEQ_DPVT *get_request_from_queue(void)
+// Merge queued read requests to the same type of devices on the same
+// sequence CPU into a single read command, as long as the devices read
+// span no more than maxWords words (up to 256). 0 or 1 disables the
+// coalescing. Read requests are coalesced up to 64 words by default.
+//
+static const iocshArg seqCoalesceArg0 = { "maxWords", iocshArgInt};
+static const iocshArg *seqCoalesceArgs[] = {
+    &seqCoalesceArg0,
+};
+
+static const iocshFuncDef seqCoalesceFuncDef = {
+    "f3rp61SeqCoalesce",
+    1,
+    seqCoalesceArgs
+};
+
+static void seqCoalesceCallFunc(const iocshArgBuf *args)
 {
-    epicsMutexMustLock(f3rp61Seq_queueMutex);
-    F3RP61_SEQ_DPVT *dpvt = (F3RP61_SEQ_DPVT *) ellGet(&f3rp61Seq_queueList);
-    epicsMutexUnlock(f3rp61Seq_queueMutex);
+    const int max_words = args[0].ival;
+
+    if (max_words < 0 || max_words > F3RP61_SEQ_MAX_COALESCE) {
+        errlogPrintf("f3rp61SeqCoalesce: maxWords must be 0 to %d\n", F3RP61_SEQ_MAX_COALESCE);
+        return;
+    }
 
-    return dpvt;
+    coalesce_max = (max_words > 1) ? max_words : 1;
 }
 
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SeqPipeline'
+//
+// usage: f3rp61SeqPipeline depth
+//
+// Allow up to depth (1 to 8) requests in flight to each sequence CPU,
+// issued by as many threads. Must be called before iocInit(). Only one
+// request is in flight by default, as the BSP may serialize commands
+// to a CPU anyway.
 //
-static void dump_mcmd_request(MCMD_STRUCT *pmcmdStruct)
+static const iocshArg seqPipelineArg0 = { "depth", iocshArgInt};
+static const iocshArg *seqPipelineArgs[] = {
+    &seqPipelineArg0,
+};
+
+static const iocshFuncDef seqPipelineFuncDef = {
+    "f3rp61SeqPipeline",
+    1,
+    seqPipelineArgs
+};
+
+static void seqPipelineCallFunc(const iocshArgBuf *args)
 {
-    MCMD_REQUEST *pmcmdRequest = &pmcmdStruct->mcmdRequest;
-    M3_WRITE_SEQDEV *pM3WriteSeqdev = (M3_WRITE_SEQDEV *) &pmcmdRequest->dataBuff.bData[0];
+    const int depth = args[0].ival;
 
-    printf("\n");
-    printf("formatCode    : 0x%02x\n", pmcmdRequest->formatCode);
-    printf("responseOption: %d\n",     pmcmdRequest->responseOption);
-    printf("srcSlot       : %d\n",     pmcmdRequest->srcSlot);
-    printf("destSlot      : %d\n",     pmcmdRequest->destSlot);
-    printf("mainCode      : 0x%02x\n", pmcmdRequest->mainCode);
-    printf("subCode       : 0x%02x\n", pmcmdRequest->subCode);
-    printf("dataSize      : %d\n",     pmcmdRequest->dataSize);
-    printf("accessType    : %d\n",     pM3WriteSeqdev->accessType);
-    printf("devType       : 0x%02x\n", pM3WriteSeqdev->devType);
-    printf("dataNum       : %d\n",     pM3WriteSeqdev->dataNum);
-    printf("topDevNo      : %ld\n",    pM3WriteSeqdev->topDevNo);
-    printf("\n");
+    if (workers_started) {
+        errlogPrintf("f3rp61SeqPipeline: must be called before iocInit\n");
+        return;
+    }
+
+    if (depth < 1 || depth > F3RP61_SEQ_MAX_PIPELINE) {
+        errlogPrintf("f3rp61SeqPipeline: depth must be 1 to %d\n", F3RP61_SEQ_MAX_PIPELINE);
+        return;
+    }
+
+    pipeline_depth = depth;
 }
 
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SeqPriority'
+//
+// usage: f3rp61SeqPriority boostWrites
+//
+// Requests to a sequence CPU are queued in order of the priority (PRIO)
+// of their records. If boostWrites is non-zero, write requests are
+// queued one level above the priority of their records, so that they
+// overtake reads of the same priority. Writes are not boosted by
+// default.
 //
-void showreq(const iocshArgBuf *args)
+static const iocshArg seqPriorityArg0 = { "boostWrites", iocshArgInt};
+static const iocshArg *seqPriorityArgs[] = {
+    &seqPriorityArg0,
+};
+
+static const iocshFuncDef seqPriorityFuncDef = {
+    "f3rp61SeqPriority",
+    1,
+    seqPriorityArgs
+};
+
+static void seqPriorityCallFunc(const iocshArgBuf *args)
 {
-    debug_flag = 1;
+    boost_writes = args[0].ival ? 1 : 0;
 }
 
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SeqPoll'
+//
+// usage: f3rp61SeqPoll address count period maxAge bits
+//
+// Poll count devices from the address (e.g. "CPU1,D1") every period
+// seconds into an image, from which records with the '&C' option read.
+// Records read the image only while it is no older than maxAge seconds
+// (three periods if 0), and get INVALID alarm otherwise. Relays are
+// read in bits if bits is non-zero, and special relays (M) always are.
+// Must be called before iocInit().
 //
-void stopshow(const iocshArgBuf *args)
+static const iocshArg seqPollArg0 = { "address", iocshArgString};
+static const iocshArg seqPollArg1 = { "count",   iocshArgInt};
+static const iocshArg seqPollArg2 = { "period",  iocshArgDouble};
+static const iocshArg seqPollArg3 = { "maxAge",  iocshArgDouble};
+static const iocshArg seqPollArg4 = { "bits",    iocshArgInt};
+static const iocshArg *seqPollArgs[] = {
+    &seqPollArg0,
+    &seqPollArg1,
+    &seqPollArg2,
+    &seqPollArg3,
+    &seqPollArg4,
+};
+
+static const iocshFuncDef seqPollFuncDef = {
+    "f3rp61SeqPoll",
+    5,
+    seqPollArgs
+};
+
+static void seqPollCallFunc(const iocshArgBuf *args)
 {
-    debug_flag = 0;
+    const char *addr = args[0].sval ? args[0].sval : "";
+    const int count = args[1].ival;
+    const double period = args[2].dval;
+    int slot = 0, top = 0;
+    char device = 0;
+
+    if (poll_started) {
+        errlogPrintf("f3rp61SeqPoll: must be called before iocInit\n");
+        return;
+    }
+
+    if (sscanf(addr, "CPU%d,%c%d", &slot, &device, &top) < 3) {
+        errlogPrintf("f3rp61SeqPoll: can't get device address from %s\n", addr);
+        return;
+    }
+
+    switch (device) {
+    case 'D': // data registers
+    case 'B': // file registers
+    case 'F': // cache registers
+    case 'Z': // special registers
+    case 'I': // internal relays
+    case 'M': // special relays
+        break;
+    default:
+        errlogPrintf("f3rp61SeqPoll: unsupported device \'%c\'\n", device);
+        return;
+    }
+
+    if (slot < 1 || slot > F3RP61_SEQ_NUM_SLOTS || count < 1 || count > 65535 || period <= 0) {
+        errlogPrintf("f3rp61SeqPoll: invalid slot, count or period\n");
+        return;
+    }
+
+    F3RP61_SEQ_POLL *ppoll = callocMustSucceed(1, sizeof(F3RP61_SEQ_POLL), "calloc failed");
+    ppoll->slot       = slot;
+    ppoll->device     = device;
+    ppoll->devType    = device - '@';
+    ppoll->accessType = (device == 'M' || args[4].ival) ? kBit : kWord;
+    ppoll->top        = top;
+    ppoll->count      = count;
+    ppoll->period     = period;
+    ppoll->max_age    = (args[3].dval > 0) ? args[3].dval : 3 * period;
+    ppoll->mutex      = epicsMutexMustCreate();
+    ppoll->image      = callocMustSucceed(count, sizeof(uint16_t), "calloc failed");
+    ppoll->buf        = callocMustSucceed(count, sizeof(uint16_t), "calloc failed");
+
+    ellAdd(&poll_list, &ppoll->node);
 }
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SeqTrace'
+//
+// usage: f3rp61SeqTrace enable
+//
+// Start (1) or stop (0) tracing the commands to sequence CPUs. The last
+// 1024 commands are kept.
+//
+static const iocshArg seqTraceArg0 = { "enable", iocshArgInt};
+static const iocshArg *seqTraceArgs[] = {
+    &seqTraceArg0,
+};
+
+static const iocshFuncDef seqTraceFuncDef = {
+    "f3rp61SeqTrace",
+    1,
+    seqTraceArgs
+};
+
+static void seqTraceCallFunc(const iocshArgBuf *args)
+{
+    epicsAtomicSetIntT(&trace_enabled, args[0].ival ? 1 : 0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SeqTraceShow'
+//
+// usage: f3rp61SeqTraceShow count slot minMs
+//
+// Show the last count (all if 0) commands traced, only those to the CPU
+// in the slot (all if 0) and taking minMs milliseconds or more from the
+// request queued to the end of the command.
+//
+static const iocshArg seqTraceShowArg0 = { "count", iocshArgInt};
+static const iocshArg seqTraceShowArg1 = { "slot",  iocshArgInt};
+static const iocshArg seqTraceShowArg2 = { "minMs", iocshArgDouble};
+static const iocshArg *seqTraceShowArgs[] = {
+    &seqTraceShowArg0,
+    &seqTraceShowArg1,
+    &seqTraceShowArg2,
+};
+
+static const iocshFuncDef seqTraceShowFuncDef = {
+    "f3rp61SeqTraceShow",
+    3,
+    seqTraceShowArgs
+};
+
+static void seqTraceShowCallFunc(const iocshArgBuf *args)
+{
+    // The entries not written yet are skipped by trace_get(), so the
+    // range may start before the first entry, or wrap around
+    const size_t last = epicsAtomicGetSizeT(&trace_next);
+    const size_t count = (args[0].ival > 0 && args[0].ival < F3RP61_SEQ_TRACE_SIZE) ?
+                          args[0].ival : F3RP61_SEQ_TRACE_SIZE;
+    const size_t first = last - count;
+
+    printf("%-15s %5s %-5s %-10s %4s %4s %6s %4s %9s %9s %9s\n",
+           "time", "comId", "cmd", "device", "num", "req", "error", "ret",
+           "wait(ms)", "ioctl(ms)", "done(ms)");
+
+    for (size_t n = first; n != last; n++) {
+        F3RP61_SEQ_TRACE trace;
+        if (trace_get(n, &trace) < 0) {
+            continue;
+        }
+
+        const double wait  = 1e3 * epicsTimeDiffInSeconds(&trace.start, &trace.queued);
+        const double ioctl = 1e3 * epicsTimeDiffInSeconds(&trace.end, &trace.start);
+        const double done  = 1e3 * epicsTimeDiffInSeconds(&trace.completed, &trace.end);
+        if ((args[1].ival > 0 && trace.slot != args[1].ival) || wait + ioctl < args[2].dval) {
+            continue;
+        }
+
+        char time[32], device[16];
+        epicsTimeToStrftime(time, sizeof(time), "%H:%M:%S.%06f", &trace.start);
+        snprintf(device, sizeof(device), "CPU%d,%c%ld", trace.slot, trace.devType + '@', trace.topDevNo);
+        printf("%-15s %5u %-5s %-10s %4u %4d 0x%04x %4d %9.3f %9.3f %9.3f\n",
+               time, trace.comId, (trace.subCode == 0x01) ? "read" : "write", device,
+               trace.dataNum, trace.requests, trace.errorCode, trace.ret, wait, ioctl, done);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SeqTraceSave'
+//
+// usage: f3rp61SeqTraceSave fileName
+//
+// Save the commands traced to a file in CSV, with the time stamps in
+// seconds past the EPICS epoch.
+//
+static const iocshArg seqTraceSaveArg0 = { "fileName", iocshArgString};
+static const iocshArg *seqTraceSaveArgs[] = {
+    &seqTraceSaveArg0,
+};
+
+static const iocshFuncDef seqTraceSaveFuncDef = {
+    "f3rp61SeqTraceSave",
+    1,
+    seqTraceSaveArgs
+};
+
+static void seqTraceSaveCallFunc(const iocshArgBuf *args)
+{
+    if (!args[0].sval) {
+        errlogPrintf("f3rp61SeqTraceSave: no file name\n");
+        return;
+    }
+
+    FILE *fp = fopen(args[0].sval, "w");
+    if (!fp) {
+        errlogPrintf("f3rp61SeqTraceSave: can't open %s [%d] : %s\n", args[0].sval, errno, strerror(errno));
+        return;
+    }
+
+    fprintf(fp, "comId,slot,subCode,accessType,devType,topDevNo,dataNum,requests,"
+                "errorCode,ret,queued,start,end,completed\n");
+
+    const size_t last = epicsAtomicGetSizeT(&trace_next);
+    const size_t first = last - F3RP61_SEQ_TRACE_SIZE;
+    for (size_t n = first; n != last; n++) {
+        F3RP61_SEQ_TRACE trace;
+        if (trace_get(n, &trace) < 0) {
+            continue;
+        }
+
+        fprintf(fp, "%u,%u,%u,%u,%u,%ld,%u,%d,%u,%d,%u.%09u,%u.%09u,%u.%09u,%u.%09u\n",
+                trace.comId, trace.slot, trace.subCode, trace.accessType, trace.devType,
+                trace.topDevNo, trace.dataNum, trace.requests, trace.errorCode, trace.ret,
+                trace.queued.secPastEpoch, trace.queued.nsec,
+                trace.start.secPastEpoch, trace.start.nsec,
+                trace.end.secPastEpoch, trace.end.nsec,
+                trace.completed.secPastEpoch, trace.completed.nsec);
+    }
+
+    fclose(fp);
+}
+
+//
+static void drvF3RP61SeqRegisterCommands(void)
+{
+    static int init_flag = 0;
+    if (init_flag) {
+        return;
+    }
+    init_flag = 1;
+
+    iocshRegister(&seqCoalesceFuncDef, seqCoalesceCallFunc);
+    iocshRegister(&seqPipelineFuncDef, seqPipelineCallFunc);
+    iocshRegister(&seqPriorityFuncDef, seqPriorityCallFunc);
+    iocshRegister(&seqPollFuncDef, seqPollCallFunc);
+    iocshRegister(&seqTraceFuncDef, seqTraceCallFunc);
+    iocshRegister(&seqTraceShowFuncDef, seqTraceShowCallFunc);
+    iocshRegister(&seqTraceSaveFuncDef, seqTraceSaveCallFunc);
+}
+
+epicsExportRegistrar(drvF3RP61SeqRegisterCommands);
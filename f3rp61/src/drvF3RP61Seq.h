@@ -2,6 +2,7 @@
 #define DRVF3RP61SEQ_H
 
 #include <fcntl.h>
+#include <stdint.h>
 #if defined(__arm__)
 #  include <m3lib.h>
 #  define DEVFILE "/dev/m3cpu"
@@ -10,8 +11,12 @@
 #  include <asm/fam3rtos/m3mcmd.h>
 #  define DEVFILE "/dev/m3mcmd"
 #else
-#  error
+#  include <drvF3RP61Sim.h>
+#  define DEVFILE "/dev/m3cpu"
 #endif
+#include <drvF3RP61Backend.h>
+#include <drvF3RP61.h>
+#include <epicsTime.h>
 
 #if defined(__powerpc__)
 #  define M3CPU_ACCS_CMD        MCMD_ACCS
@@ -29,17 +34,62 @@ typedef enum {
     // kLong = 0x04, // F3RP71 native API does not suport long-word access
 } F3RP61_ACCESS_TYPE;
 
+// Range of devices polled in bulk into an image, from which records in
+// the cached mode ('&C' option) read synchronously (see drvF3RP61Seq.c)
+typedef struct F3RP61_SEQ_POLL F3RP61_SEQ_POLL;
+
+// Words read or written by a request at most (&D option)
+#define F3RP61_SEQ_MAX_WORDS 4
+
+// Devices of a sequence CPU accessed by a request. The message command
+// is composed from it in a buffer of the driver only when issued.
+typedef struct {
+    unsigned short srcSlot;
+    unsigned short destSlot;
+    unsigned short subCode;    // 0x01 to read, 0x02 to write
+    unsigned short accessType;
+    unsigned short devType;
+    long           topDevNo;
+    unsigned short dataNum;
+} F3RP61_SEQ_ADDR;
+
 //
 typedef struct {
     ELLNODE      node;
-    MCMD_STRUCT  mcmdStruct;
+    F3RP61_SEQ_ADDR addr;
+    uint16_t     wData[F3RP61_SEQ_MAX_WORDS]; // to write, or read on completion
+    unsigned short errorCode; // of the response on completion
     dbCommon    *prec;
     CALLBACK     callback;
     int          ret;
+    int          priority; // in the queue, set by f3rp61Seq_queueRequest()
     char         option;
+    F3RP61_SEQ_POLL *ppoll; // polled image in the cached mode, if any
+    ELLLIST      waiters; // identical reads attached to this one while queued
+    void        *inbox_next; // next in the lock-free inbox of the worker
+    epicsTimeStamp queued; // when queued, set by f3rp61Seq_queueRequest()
+    epicsUInt64  queued_at; // monotonic time when queued, in ns, for the statistics
 } F3RP61_SEQ_DPVT;
 
+// Statistics of the requests to a sequence CPU, or of all the CPUs when
+// read with slot of 0
+typedef struct {
+    unsigned long  requests;   // requests completed, including attached ones
+    unsigned long  commands;   // commands issued
+    unsigned long  errors;     // commands failed or returning error code
+    double         rate;       // requests completed per second
+    int            queued;     // requests waiting for their commands
+    int            queued_max; // high-water mark of queued
+    F3RP61_LATENCY wait;       // queueing to the start of the command
+    F3RP61_LATENCY service;    // the command in ioctl()
+} F3RP61_SEQ_STAT;
+
 int f3rp61Seq_queueRequest();
+int f3rp61Seq_parseCachedOption(char *);
+long f3rp61Seq_attachPoll(F3RP61_SEQ_DPVT *);
+long f3rp61Seq_readPoll(dbCommon *, F3RP61_SEQ_DPVT *);
+long f3rp61Seq_getStat(int, F3RP61_SEQ_STAT *);
+long f3rp61Seq_getReadback(const F3RP61_SEQ_ADDR *, uint16_t *);
 
 extern int f3rp61Seq_fd;
 
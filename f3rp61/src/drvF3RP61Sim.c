@@ -0,0 +1,900 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* drvF3RP61Sim.c - Simulated Backend for Host Builds of F3RP61
+*
+*      Date: 2026 Oct. 16
+*/
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/msg.h>
+#include <sys/types.h>
+#include <time.h>
+
+#include <cantProceed.h>
+#include <epicsMutex.h>
+#include <epicsThread.h>
+#include <errlog.h>
+#include <iocsh.h>
+
+#include <drvF3RP61Backend.h>
+
+// The simulator models the devices in memory:
+//
+// - input relays (X), output relays (Y), data registers (A) and mode
+//   registers of I/O modules on every (unit, slot),
+// - shared registers (R), shared relays (E), link registers (W), link
+//   relays (L) and memory of CPUs,
+// - internal devices of sequence CPUs, accessed by M3CPU_ACCS_CMD,
+// - LEDs of the system control,
+// - interrupts, delivered to the SysV message queues given by
+//   M3IO_ENABLE_INTER as the BSP does.
+//
+// The contents of the devices are set and shown with iocsh commands,
+// and interrupts are generated with an iocsh command as well. Accesses
+// can be delayed to model the time taken by the I/O bus and by the
+// sequence CPUs.
+
+#define SIM_NUM_RELAY_WORDS  64    // X and Y relays per module, 1024 relays
+#define SIM_NUM_CHANNELS     (SIM_NUM_RELAY_WORDS * 16 + 1) // interrupt channels from 1
+#define SIM_NUM_REGS         4096  // A registers per module
+#define SIM_NUM_MODE_REGS    16    // mode registers per module
+#define SIM_NUM_COM_WORDS    16384 // R registers, E relays, W registers, L relays
+#define SIM_NUM_CPUS         4
+#define SIM_NUM_CPU_WORDS    65536 // memory per CPU
+#define SIM_NUM_SEQ_DEVS     65536 // internal devices per device type
+#define SIM_NUM_SEQ_TYPES    32
+
+// File descriptors of the simulated device files
+#define SIM_FD_M3IO          1000
+#define SIM_FD_M3CPU         1001
+#define SIM_FD_M3SYSCTL      1002
+
+//
+typedef struct {
+    uint16_t inrly[SIM_NUM_RELAY_WORDS];
+    uint16_t outrly[SIM_NUM_RELAY_WORDS];
+    uint16_t reg[SIM_NUM_REGS];
+    uint16_t mode[SIM_NUM_MODE_REGS];
+    int msqid[SIM_NUM_CHANNELS]; // by interrupt channel, -1 if disabled
+    M3IO_MODULE_INFORMATION info;
+} SIM_MODULE;
+
+static epicsMutexId sim_mutex;
+static SIM_MODULE *sim_modules[M3IO_NUM_UNIT][M3IO_NUM_SLOT + 1];
+static uint16_t sim_com_reg[SIM_NUM_COM_WORDS];
+static uint16_t sim_com_rly[SIM_NUM_COM_WORDS];
+static uint16_t sim_link_reg[SIM_NUM_COM_WORDS];
+static uint16_t sim_link_rly[SIM_NUM_COM_WORDS];
+static uint16_t *sim_cpu_mem[SIM_NUM_CPUS + 1];
+static uint16_t *sim_seq_dev[SIM_NUM_SEQ_TYPES];
+static unsigned long sim_led;
+static int sim_io_delay;   // in microseconds
+static int sim_mcmd_delay; // in microseconds
+
+static void sim_init(void *);
+static SIM_MODULE *get_module(int, int);
+static uint16_t *get_cpu_mem(int);
+static uint16_t *get_seq_dev(int);
+static void sim_delay(int);
+static int copy_words(uint16_t *, int, int, int, unsigned short *, int);
+static int copy_bits(uint16_t *, int, int, int, unsigned char *, int);
+static int sim_mcmd(MCMD_STRUCT *);
+static int parse_address(const char *, uint16_t **, int *);
+static void simModuleCallFunc(const iocshArgBuf *);
+static void simPutCallFunc(const iocshArgBuf *);
+static void simGetCallFunc(const iocshArgBuf *);
+static void simInterruptCallFunc(const iocshArgBuf *);
+static void simDelayCallFunc(const iocshArgBuf *);
+static void sim_register_commands(void);
+
+//
+static void sim_init(void *arg)
+{
+    sim_mutex = epicsMutexMustCreate();
+}
+
+static void sim_lock(void)
+{
+    static epicsThreadOnceId once = EPICS_THREAD_ONCE_INIT;
+    epicsThreadOnce(&once, sim_init, NULL);
+    epicsMutexMustLock(sim_mutex);
+}
+
+static void sim_unlock(void)
+{
+    epicsMutexUnlock(sim_mutex);
+}
+
+// Get the module on (unit, slot), which is created on demand.
+// Must be called with the simulator locked.
+static SIM_MODULE *get_module(int unit, int slot)
+{
+    if (unit < 0 || unit >= M3IO_NUM_UNIT || slot < 1 || slot > M3IO_NUM_SLOT) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (!sim_modules[unit][slot]) {
+        SIM_MODULE *pmodule = callocMustSucceed(1, sizeof(SIM_MODULE), "calloc failed");
+        for (int i = 0; i < SIM_NUM_CHANNELS; i++) {
+            pmodule->msqid[i] = -1;
+        }
+        pmodule->info.unitno = unit;
+        pmodule->info.slotno = slot;
+        sim_modules[unit][slot] = pmodule;
+    }
+
+    return sim_modules[unit][slot];
+}
+
+static uint16_t *get_cpu_mem(int cpuno)
+{
+    if (cpuno < 1 || cpuno > SIM_NUM_CPUS) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (!sim_cpu_mem[cpuno]) {
+        sim_cpu_mem[cpuno] = callocMustSucceed(SIM_NUM_CPU_WORDS, sizeof(uint16_t), "calloc failed");
+    }
+
+    return sim_cpu_mem[cpuno];
+}
+
+static uint16_t *get_seq_dev(int devtype)
+{
+    if (devtype < 0 || devtype >= SIM_NUM_SEQ_TYPES) {
+        return NULL;
+    }
+
+    if (!sim_seq_dev[devtype]) {
+        sim_seq_dev[devtype] = callocMustSucceed(SIM_NUM_SEQ_DEVS + 1, sizeof(uint16_t), "calloc failed");
+    }
+
+    return sim_seq_dev[devtype];
+}
+
+// Model the time taken by an access
+static void sim_delay(int usec)
+{
+    if (usec > 0) {
+        struct timespec ts = {
+            .tv_sec  = usec / 1000000,
+            .tv_nsec = (usec % 1000000) * 1000,
+        };
+        nanosleep(&ts, NULL);
+    }
+}
+
+// Copy count words from/to mem[index], mem having size words
+static int copy_words(uint16_t *mem, int size, int index, int count, unsigned short *data, int write)
+{
+    if (!mem || index < 0 || count < 0 || index + count > size) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (write) {
+        memcpy(&mem[index], data, count * sizeof(uint16_t));
+    } else {
+        memcpy(data, &mem[index], count * sizeof(uint16_t));
+    }
+
+    return 0;
+}
+
+// Copy count relays, one in a byte, from/to relay number position
+// (starting from 1) in mem having size words
+static int copy_bits(uint16_t *mem, int size, int position, int count, unsigned char *data, int write)
+{
+    if (!mem || position < 1 || count < 0 || position - 1 + count > size * 16) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const int bit = position - 1 + i;
+        const uint16_t mask = 1 << (bit % 16);
+        if (write) {
+            mem[bit / 16] = data[i] ? (mem[bit / 16] | mask) : (mem[bit / 16] & ~mask);
+        } else {
+            data[i] = (mem[bit / 16] & mask) ? 1 : 0;
+        }
+    }
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Device files
+//
+static int sim_open(const char *path, int flags)
+{
+    if (strcmp(path, "/dev/m3io") == 0) {
+        return SIM_FD_M3IO;
+    }
+    if (strcmp(path, "/dev/m3cpu") == 0) {
+        return SIM_FD_M3CPU;
+    }
+    if (strcmp(path, "/dev/m3sysctl") == 0) {
+        return SIM_FD_M3SYSCTL;
+    }
+
+    errno = ENOENT;
+    return -1;
+}
+
+static int sim_ioctl_m3io(unsigned long request, void *arg)
+{
+    if (request == M3IO_ENABLE_INTER) {
+        M3IO_INTER_DEFINE *pdef = arg;
+        SIM_MODULE *pmodule = get_module(pdef->unitno, pdef->slotno);
+        const int channel = pdef->defData.relayNo;
+        if (!pmodule || channel < 1 || channel >= SIM_NUM_CHANNELS) {
+            errno = EINVAL;
+            return -1;
+        }
+        pmodule->msqid[channel] = pdef->msgQId;
+        return 0;
+    }
+
+    if (request == M3IO_GET_MODULE_INFO) {
+        M3IO_MODULE_INFORMATION *pinfo = arg;
+        SIM_MODULE *pmodule = get_module(pinfo->unitno, pinfo->slotno);
+        if (!pmodule) {
+            return -1;
+        }
+        *pinfo = pmodule->info;
+        return 0;
+    }
+
+    if (request == M3IO_READ_INRELAY_POINT || request == M3IO_WRITE_OUTRELAY_POINT) {
+        M3IO_ACCESS_RELAY_POINT *ppoint = arg;
+        SIM_MODULE *pmodule = get_module(ppoint->unitno, ppoint->slotno);
+        if (!pmodule) {
+            return -1;
+        }
+        unsigned char data = ppoint->data;
+        if (request == M3IO_READ_INRELAY_POINT) {
+            if (copy_bits(pmodule->inrly, SIM_NUM_RELAY_WORDS, ppoint->position, 1, &data, 0) < 0) {
+                return -1;
+            }
+            ppoint->data = data;
+            return 0;
+        }
+        return copy_bits(pmodule->outrly, SIM_NUM_RELAY_WORDS, ppoint->position, 1, &data, 1);
+    }
+
+    M3IO_ACCESS_REG *pdrly = arg;
+    SIM_MODULE *pmodule = get_module(pdrly->unitno, pdrly->slotno);
+    if (!pmodule) {
+        return -1;
+    }
+
+    const int word  = (pdrly->start - 1) / 16; // for relays
+    const int count = pdrly->count;
+
+    switch (request) {
+    case M3IO_READ_INRELAY:
+        if (word < 0 || count > M3IO_NUM_RELAY_WORD || word + count > SIM_NUM_RELAY_WORDS ||
+            (pmodule->info.enable && word + count > pmodule->info.num_xreg)) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            pdrly->u.inrly[i].data = pmodule->inrly[word + i];
+        }
+        return 0;
+
+    case M3IO_READ_OUTRELAY:
+        if (word < 0 || count > M3IO_NUM_RELAY_WORD || word + count > SIM_NUM_RELAY_WORDS ||
+            (pmodule->info.enable && word + count > pmodule->info.num_yreg)) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            pdrly->u.outrly[i].data = pmodule->outrly[word + i];
+        }
+        return 0;
+
+    case M3IO_WRITE_OUTRELAY:
+        if (word < 0 || count > M3IO_NUM_RELAY_WORD || word + count > SIM_NUM_RELAY_WORDS ||
+            (pmodule->info.enable && word + count > pmodule->info.num_yreg)) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            const uint16_t mask = pdrly->u.outrly[i].mask;
+            pmodule->outrly[word + i] = (pmodule->outrly[word + i] & ~mask) | (pdrly->u.outrly[i].data & mask);
+        }
+        return 0;
+
+    case M3IO_READ_REG:
+        return copy_words(pmodule->reg, SIM_NUM_REGS, pdrly->start - 1, count, pdrly->u.pwdata, 0);
+
+    case M3IO_WRITE_REG:
+        return copy_words(pmodule->reg, SIM_NUM_REGS, pdrly->start - 1, count, pdrly->u.pwdata, 1);
+
+    case M3IO_READ_REG_L:
+        // Lower word comes from the lower register
+        if (pdrly->start < 1 || count < 0 || pdrly->start - 1 + 2 * count > SIM_NUM_REGS) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            const uint16_t *preg = &pmodule->reg[pdrly->start - 1 + 2 * i];
+            pdrly->u.pldata[i] = ((unsigned long) preg[1] << 16) | preg[0];
+        }
+        return 0;
+
+    case M3IO_WRITE_REG_L:
+        if (pdrly->start < 1 || count < 0 || pdrly->start - 1 + 2 * count > SIM_NUM_REGS) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            uint16_t *preg = &pmodule->reg[pdrly->start - 1 + 2 * i];
+            preg[0] = pdrly->u.pldata[i] & 0xffff;
+            preg[1] = (pdrly->u.pldata[i] >> 16) & 0xffff;
+        }
+        return 0;
+    }
+
+    errno = EINVAL;
+    return -1;
+}
+
+static int sim_ioctl_m3cpu(unsigned long request, void *arg)
+{
+    switch (request) {
+    case M3CPU_GET_NUM:
+        *(int *) arg = 1; // the IOC is always in slot 1
+        return 0;
+
+    case M3CPU_ACCS_CMD:
+        return sim_mcmd(arg);
+    }
+
+    errno = EINVAL;
+    return -1;
+}
+
+static int sim_ioctl_m3sysctl(unsigned long request, void *arg)
+{
+    unsigned long *pdata = arg;
+    const unsigned long mask = *pdata >> 16;
+
+    switch (request) {
+    case M3SC_SET_LED:
+    case M3SC_SET_US_LED:
+        sim_led = (sim_led & ~mask) | (*pdata & mask);
+        return 0;
+
+    case M3SC_GET_LED:
+        *pdata = sim_led & (LED_RUN_FLG | LED_ALM_FLG | LED_ERR_FLG);
+        return 0;
+
+    case M3SC_GET_US_LED:
+        *pdata = sim_led & (LED_US1_FLG | LED_US2_FLG | LED_US3_FLG);
+        return 0;
+
+    case M3SC_GET_SW:
+    case M3SC_CHECK_BAT:
+        *pdata = 0;
+        return 0;
+    }
+
+    errno = EINVAL;
+    return -1;
+}
+
+static int sim_ioctl(int fd, unsigned long request, void *arg)
+{
+    int ret = -1;
+
+    if (fd == SIM_FD_M3CPU && request == M3CPU_ACCS_CMD) {
+        sim_delay(sim_mcmd_delay);
+    } else if (fd == SIM_FD_M3IO) {
+        sim_delay(sim_io_delay);
+    }
+
+    sim_lock();
+    switch (fd) {
+    case SIM_FD_M3IO:
+        ret = sim_ioctl_m3io(request, arg);
+        break;
+    case SIM_FD_M3CPU:
+        ret = sim_ioctl_m3cpu(request, arg);
+        break;
+    case SIM_FD_M3SYSCTL:
+        ret = sim_ioctl_m3sysctl(request, arg);
+        break;
+    default:
+        errno = EBADF;
+        break;
+    }
+    sim_unlock();
+
+    return ret;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Commands to sequence CPUs
+//
+// Reading (0x26, 0x01) and writing (0x26, 0x02) internal devices are
+// supported. Must be called with the simulator locked.
+//
+static int sim_mcmd(MCMD_STRUCT *pmcmdStruct)
+{
+    MCMD_REQUEST  *preq  = &pmcmdStruct->mcmdRequest;
+    MCMD_RESPONSE *presp = &pmcmdStruct->mcmdResponse;
+
+    presp->formatCode     = preq->formatCode;
+    presp->responseOption = preq->responseOption;
+    presp->srcSlot        = preq->destSlot;
+    presp->destSlot       = preq->srcSlot;
+    presp->mainCode       = preq->mainCode;
+    presp->subCode        = preq->subCode;
+    presp->comId          = preq->comId;
+    presp->errorCode      = 0;
+    presp->dataSize       = 0;
+
+    if (preq->mainCode == 0x26 && preq->subCode == 0x01) {
+        M3_READ_SEQDEV *pread = (M3_READ_SEQDEV *) &preq->dataBuff.bData[0];
+        uint16_t *pdev = get_seq_dev(pread->devType);
+        if (copy_words(pdev, SIM_NUM_SEQ_DEVS + 1, pread->topDevNo, pread->dataNum, presp->dataBuff.wData, 0) < 0) {
+            presp->errorCode = 0x0001;
+            return 0;
+        }
+        presp->dataSize = 2 * pread->dataNum;
+        return 0;
+    }
+
+    if (preq->mainCode == 0x26 && preq->subCode == 0x02) {
+        M3_WRITE_SEQDEV *pwrite = (M3_WRITE_SEQDEV *) &preq->dataBuff.bData[0];
+        uint16_t *pdev = get_seq_dev(pwrite->devType);
+        if (copy_words(pdev, SIM_NUM_SEQ_DEVS + 1, pwrite->topDevNo, pwrite->dataNum, pwrite->dataBuff.wData, 1) < 0) {
+            presp->errorCode = 0x0001;
+        }
+        return 0;
+    }
+
+    presp->errorCode = 0x0002; // command not supported
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Shared devices, link devices and CPU memory
+//
+// Registers and relays are numbered from 1, and relays are accessed in
+// 16-bit words starting from relay number 1, 17, 33, ... or in bytes of
+// one relay each (functions ending with 'B').
+//
+#define SIM_WORDS(name, mem, index, write)                                  \
+static int sim_##name(int start, int count, unsigned short *data)           \
+{                                                                           \
+    sim_delay(sim_io_delay);                                                \
+    sim_lock();                                                             \
+    const int ret = copy_words(mem, SIM_NUM_COM_WORDS, index, count, data, write); \
+    sim_unlock();                                                           \
+    return ret;                                                             \
+}
+
+#define SIM_BITS(name, mem, write)                                          \
+static int sim_##name(int start, int count, unsigned char *data)            \
+{                                                                           \
+    sim_delay(sim_io_delay);                                                \
+    sim_lock();                                                             \
+    const int ret = copy_bits(mem, SIM_NUM_COM_WORDS, start, count, data, write); \
+    sim_unlock();                                                           \
+    return ret;                                                             \
+}
+
+SIM_WORDS(readM3ComRegister,   sim_com_reg,  start - 1,        0)
+SIM_WORDS(writeM3ComRegister,  sim_com_reg,  start - 1,        1)
+SIM_WORDS(readM3ComRelay,      sim_com_rly,  (start - 1) / 16, 0)
+SIM_WORDS(writeM3ComRelay,     sim_com_rly,  (start - 1) / 16, 1)
+SIM_WORDS(readM3LinkRegister,  sim_link_reg, start - 1,        0)
+SIM_WORDS(writeM3LinkRegister, sim_link_reg, start - 1,        1)
+SIM_WORDS(readM3LinkRelay,     sim_link_rly, (start - 1) / 16, 0)
+SIM_WORDS(writeM3LinkRelay,    sim_link_rly, (start - 1) / 16, 1)
+SIM_BITS(readM3ComRelayB,   sim_com_rly,  0)
+SIM_BITS(writeM3ComRelayB,  sim_com_rly,  1)
+SIM_BITS(readM3LinkRelayB,  sim_link_rly, 0)
+SIM_BITS(writeM3LinkRelayB, sim_link_rly, 1)
+
+static int sim_readM3CpuMemory(int cpuno, int start, int count, unsigned short *data)
+{
+    sim_delay(sim_io_delay);
+    sim_lock();
+    const int ret = copy_words(get_cpu_mem(cpuno), SIM_NUM_CPU_WORDS, start, count, data, 0);
+    sim_unlock();
+    return ret;
+}
+
+static int sim_writeM3CpuMemory(int cpuno, int start, int count, unsigned short *data)
+{
+    sim_delay(sim_io_delay);
+    sim_lock();
+    const int ret = copy_words(get_cpu_mem(cpuno), SIM_NUM_CPU_WORDS, start, count, data, 1);
+    sim_unlock();
+    return ret;
+}
+
+static int sim_readM3IoModeRegister(int unitno, int slotno, int start, int count, unsigned short *data)
+{
+    sim_delay(sim_io_delay);
+    sim_lock();
+    SIM_MODULE *pmodule = get_module(unitno, slotno);
+    const int ret = pmodule ? copy_words(pmodule->mode, SIM_NUM_MODE_REGS, start - 1, count, data, 0) : -1;
+    sim_unlock();
+    return ret;
+}
+
+static int sim_writeM3IoModeRegister(int unitno, int slotno, int start, int count, unsigned short *data)
+{
+    sim_delay(sim_io_delay);
+    sim_lock();
+    SIM_MODULE *pmodule = get_module(unitno, slotno);
+    const int ret = pmodule ? copy_words(pmodule->mode, SIM_NUM_MODE_REGS, start - 1, count, data, 1) : -1;
+    sim_unlock();
+    return ret;
+}
+
+// Configuration of shared devices and link devices has nothing to do
+static int sim_setM3ComDataConfig(M3COMDATACONFIG *pconfig, M3COMDATACONFIG *pext_config)
+{
+    return 0;
+}
+
+static int sim_setM3LinkDeviceConfig(M3LINKDATACONFIG *pconfig)
+{
+    return 0;
+}
+
+static int sim_setM3FlnSysNo(int sysno, void *parg)
+{
+    return 0;
+}
+
+static int sim_m3rfrsTsk(int period)
+{
+    return 0;
+}
+
+const F3RP61_BACKEND f3rp61_sim_backend = {
+    .name                   = "Simulator",
+    .open                   = sim_open,
+    .ioctl                  = sim_ioctl,
+    .readM3ComRegister      = sim_readM3ComRegister,
+    .writeM3ComRegister     = sim_writeM3ComRegister,
+    .readM3ComRelay         = sim_readM3ComRelay,
+    .writeM3ComRelay        = sim_writeM3ComRelay,
+    .readM3ComRelayB        = sim_readM3ComRelayB,
+    .writeM3ComRelayB       = sim_writeM3ComRelayB,
+    .readM3LinkRegister     = sim_readM3LinkRegister,
+    .writeM3LinkRegister    = sim_writeM3LinkRegister,
+    .readM3LinkRelay        = sim_readM3LinkRelay,
+    .writeM3LinkRelay       = sim_writeM3LinkRelay,
+    .readM3LinkRelayB       = sim_readM3LinkRelayB,
+    .writeM3LinkRelayB      = sim_writeM3LinkRelayB,
+    .readM3CpuMemory        = sim_readM3CpuMemory,
+    .writeM3CpuMemory       = sim_writeM3CpuMemory,
+    .readM3IoModeRegister   = sim_readM3IoModeRegister,
+    .writeM3IoModeRegister  = sim_writeM3IoModeRegister,
+    .setM3ComDataConfig     = sim_setM3ComDataConfig,
+    .setM3LinkDeviceConfig  = sim_setM3LinkDeviceConfig,
+    .setM3FlnSysNo          = sim_setM3FlnSysNo,
+    .m3rfrsTsk              = sim_m3rfrsTsk,
+    .registerCommands       = sim_register_commands,
+};
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Parse an address of a word or a relay in the same format as the INP /
+// OUT fields, e.g. "U0,S3,A1", "U0,S2,X1", "R1", "E1", "CPU2,D100".
+// Returns the word and the bit number (-1 for a word) of the address.
+// Must be called with the simulator locked.
+//
+static int parse_address(const char *addr, uint16_t **pword, int *pbit)
+{
+    int unit, slot, cpu, number;
+    char device;
+    uint16_t *mem = NULL;
+    int size = 0, relay = 0;
+
+    if (sscanf(addr, "U%d,S%d,%c%d", &unit, &slot, &device, &number) == 4) {
+        SIM_MODULE *pmodule = get_module(unit, slot);
+        if (!pmodule) {
+            return -1;
+        }
+        switch (device) {
+        case 'X': mem = pmodule->inrly; size = SIM_NUM_RELAY_WORDS; relay = 1; break;
+        case 'Y': mem = pmodule->outrly; size = SIM_NUM_RELAY_WORDS; relay = 1; break;
+        case 'A': mem = pmodule->reg; size = SIM_NUM_REGS; break;
+        case 'M': mem = pmodule->mode; size = SIM_NUM_MODE_REGS; break;
+        }
+
+    } else if (sscanf(addr, "CPU%d,%c%d", &cpu, &device, &number) == 3) {
+        mem  = get_seq_dev(device - '@');
+        size = SIM_NUM_SEQ_DEVS + 1;
+        number++; // devices are numbered from 1 but indexed as is
+
+    } else if (sscanf(addr, "%c%d", &device, &number) == 2) {
+        switch (device) {
+        case 'R': mem = sim_com_reg; size = SIM_NUM_COM_WORDS; break;
+        case 'E': mem = sim_com_rly; size = SIM_NUM_COM_WORDS; relay = 1; break;
+        case 'W': mem = sim_link_reg; size = SIM_NUM_COM_WORDS; break;
+        case 'L': mem = sim_link_rly; size = SIM_NUM_COM_WORDS; relay = 1; break;
+        }
+    }
+
+    if (!mem || number < 1 || number > (relay ? size * 16 : size)) {
+        return -1;
+    }
+
+    if (relay) {
+        *pword = &mem[(number - 1) / 16];
+        *pbit  = (number - 1) % 16;
+    } else {
+        *pword = &mem[number - 1];
+        *pbit  = -1;
+    }
+
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SimModule'
+//
+// usage: f3rp61SimModule unit slot name nXreg nYreg nDreg
+//
+// Install a simulated module, which is shown by f3rp61GetModuleInfo.
+// Modules which are not installed can be accessed all the same.
+//
+static const iocshArg simModuleArg0 = { "unit",  iocshArgInt};
+static const iocshArg simModuleArg1 = { "slot",  iocshArgInt};
+static const iocshArg simModuleArg2 = { "name",  iocshArgString};
+static const iocshArg simModuleArg3 = { "nXreg", iocshArgInt};
+static const iocshArg simModuleArg4 = { "nYreg", iocshArgInt};
+static const iocshArg simModuleArg5 = { "nDreg", iocshArgInt};
+static const iocshArg *simModuleArgs[] = {
+    &simModuleArg0,
+    &simModuleArg1,
+    &simModuleArg2,
+    &simModuleArg3,
+    &simModuleArg4,
+    &simModuleArg5,
+};
+
+static const iocshFuncDef simModuleFuncDef = {
+    "f3rp61SimModule",
+    6,
+    simModuleArgs
+};
+
+static void simModuleCallFunc(const iocshArgBuf *args)
+{
+    const char *name = args[2].sval ? args[2].sval : "";
+
+    sim_lock();
+    SIM_MODULE *pmodule = get_module(args[0].ival, args[1].ival);
+    if (pmodule) {
+        pmodule->info.enable = 1;
+        memset(pmodule->info.name, ' ', sizeof(pmodule->info.name));
+        memcpy(pmodule->info.name, name, strnlen(name, sizeof(pmodule->info.name)));
+        pmodule->info.num_xreg = args[3].ival;
+        pmodule->info.num_yreg = args[4].ival;
+        pmodule->info.num_dreg = args[5].ival;
+    }
+    sim_unlock();
+
+    if (!pmodule) {
+        errlogPrintf("f3rp61SimModule: no such slot (U%d,S%d)\n", args[0].ival, args[1].ival);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SimPut'
+//
+// usage: f3rp61SimPut address value
+//
+// Set a register or a relay, e.g. "U0,S3,A1", "U0,S2,X1", "R1", "E1",
+// "CPU2,D100".
+//
+static const iocshArg simPutArg0 = { "address", iocshArgString};
+static const iocshArg simPutArg1 = { "value",   iocshArgInt};
+static const iocshArg *simPutArgs[] = {
+    &simPutArg0,
+    &simPutArg1,
+};
+
+static const iocshFuncDef simPutFuncDef = {
+    "f3rp61SimPut",
+    2,
+    simPutArgs
+};
+
+static void simPutCallFunc(const iocshArgBuf *args)
+{
+    const char *addr = args[0].sval ? args[0].sval : "";
+    uint16_t *pword;
+    int bit;
+
+    sim_lock();
+    const int ret = parse_address(addr, &pword, &bit);
+    if (ret == 0) {
+        if (bit < 0) {
+            *pword = args[1].ival;
+        } else if (args[1].ival) {
+            *pword |= (1 << bit);
+        } else {
+            *pword &= ~(1 << bit);
+        }
+    }
+    sim_unlock();
+
+    if (ret < 0) {
+        errlogPrintf("f3rp61SimPut: invalid address %s\n", addr);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SimGet'
+//
+// usage: f3rp61SimGet address
+//
+// Show a register or a relay.
+//
+static const iocshArg simGetArg0 = { "address", iocshArgString};
+static const iocshArg *simGetArgs[] = {
+    &simGetArg0,
+};
+
+static const iocshFuncDef simGetFuncDef = {
+    "f3rp61SimGet",
+    1,
+    simGetArgs
+};
+
+static void simGetCallFunc(const iocshArgBuf *args)
+{
+    const char *addr = args[0].sval ? args[0].sval : "";
+    uint16_t *pword;
+    int bit;
+    int value = 0;
+
+    sim_lock();
+    const int ret = parse_address(addr, &pword, &bit);
+    if (ret == 0) {
+        value = (bit < 0) ? *pword : ((*pword >> bit) & 1);
+    }
+    sim_unlock();
+
+    if (ret < 0) {
+        errlogPrintf("f3rp61SimGet: invalid address %s\n", addr);
+        return;
+    }
+
+    printf("%s = %d (0x%04x)\n", addr, value, value);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SimInterrupt'
+//
+// usage: f3rp61SimInterrupt unit slot channel count interval
+//
+// Generate count interrupts (at least one) on the channel of the module
+// with the given interval in microseconds.
+//
+static const iocshArg simInterruptArg0 = { "unit",     iocshArgInt};
+static const iocshArg simInterruptArg1 = { "slot",     iocshArgInt};
+static const iocshArg simInterruptArg2 = { "channel",  iocshArgInt};
+static const iocshArg simInterruptArg3 = { "count",    iocshArgInt};
+static const iocshArg simInterruptArg4 = { "interval", iocshArgInt};
+static const iocshArg *simInterruptArgs[] = {
+    &simInterruptArg0,
+    &simInterruptArg1,
+    &simInterruptArg2,
+    &simInterruptArg3,
+    &simInterruptArg4,
+};
+
+static const iocshFuncDef simInterruptFuncDef = {
+    "f3rp61SimInterrupt",
+    5,
+    simInterruptArgs
+};
+
+static void simInterruptCallFunc(const iocshArgBuf *args)
+{
+    const int unit    = args[0].ival;
+    const int slot    = args[1].ival;
+    const int channel = args[2].ival;
+    const int count   = (args[3].ival > 0) ? args[3].ival : 1;
+    int msqid = -1;
+
+    sim_lock();
+    SIM_MODULE *pmodule = get_module(unit, slot);
+    if (pmodule && channel >= 1 && channel < SIM_NUM_CHANNELS) {
+        msqid = pmodule->msqid[channel];
+    }
+    sim_unlock();
+
+    if (msqid == -1) {
+        errlogPrintf("f3rp61SimInterrupt: interrupt is not enabled on (U%d,S%d,X%d)\n", unit, slot, channel);
+        return;
+    }
+
+    struct {
+        long mtype;
+        M3IO_MSG_IO mtext;
+    } msgbuf = {
+        .mtype = M3IO_MSGTYPE_IO,
+        .mtext = {
+            .unit    = unit,
+            .slot    = slot,
+            .channel = channel,
+        },
+    };
+
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            sim_delay(args[4].ival);
+        }
+        if (msgsnd(msqid, &msgbuf, sizeof(msgbuf.mtext), IPC_NOWAIT) < 0) {
+            errlogPrintf("f3rp61SimInterrupt: msgsnd failed [%d] : %s\n", errno, strerror(errno));
+            return;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Register iocsh command 'f3rp61SimDelay'
+//
+// usage: f3rp61SimDelay ioDelay mcmdDelay
+//
+// Set the time in microseconds taken by each access to I/O modules and
+// shared/link devices, and by each command to sequence CPUs.
+//
+static const iocshArg simDelayArg0 = { "ioDelay",   iocshArgInt};
+static const iocshArg simDelayArg1 = { "mcmdDelay", iocshArgInt};
+static const iocshArg *simDelayArgs[] = {
+    &simDelayArg0,
+    &simDelayArg1,
+};
+
+static const iocshFuncDef simDelayFuncDef = {
+    "f3rp61SimDelay",
+    2,
+    simDelayArgs
+};
+
+static void simDelayCallFunc(const iocshArgBuf *args)
+{
+    sim_io_delay   = args[0].ival;
+    sim_mcmd_delay = args[1].ival;
+}
+
+//
+static void sim_register_commands(void)
+{
+    iocshRegister(&simModuleFuncDef, simModuleCallFunc);
+    iocshRegister(&simPutFuncDef, simPutCallFunc);
+    iocshRegister(&simGetFuncDef, simGetCallFunc);
+    iocshRegister(&simInterruptFuncDef, simInterruptCallFunc);
+    iocshRegister(&simDelayFuncDef, simDelayCallFunc);
+}
@@ -0,0 +1,203 @@
+#ifndef DRVF3RP61SIM_H
+#define DRVF3RP61SIM_H
+
+// Definitions of the BSP API (m3lib.h of F3RP71) used by the device /
+// driver support, for host builds with the simulated backend. Only the
+// members referred to by the device / driver support are modeled.
+
+#include <stdint.h>
+#include <sys/types.h>
+
+//
+#define M3IO_NUM_UNIT       8
+#define M3IO_NUM_SLOT       16
+#define M3IO_NUM_RELAY_WORD 64  // relay words in a single request
+#define M3IO_MSGTYPE_IO     1
+
+// ioctl requests on /dev/m3io
+#define M3IO_READ_INRELAY           0x0101
+#define M3IO_READ_INRELAY_POINT     0x0102
+#define M3IO_READ_OUTRELAY          0x0103
+#define M3IO_WRITE_OUTRELAY         0x0104
+#define M3IO_WRITE_OUTRELAY_POINT   0x0105
+#define M3IO_READ_REG               0x0106
+#define M3IO_READ_REG_L             0x0107
+#define M3IO_WRITE_REG              0x0108
+#define M3IO_WRITE_REG_L            0x0109
+#define M3IO_READ_MODE              0x010a
+#define M3IO_WRITE_MODE             0x010b
+#define M3IO_READ_COM               0x010c
+#define M3IO_WRITE_COM              0x010d
+#define M3IO_ENABLE_INTER           0x010e
+#define M3IO_GET_MODULE_INFO        0x010f
+
+// ioctl requests on /dev/m3cpu
+#define M3CPU_ACCS_CMD              0x0201
+#define M3CPU_GET_NUM               0x0202
+#define M3CPU_GET_TYPE              0x0203
+#define M3CPU_READ_COM              0x0204
+#define M3CPU_WRITE_COM             0x0205
+#define M3CPU_SEND_SIG_EVENT        0x0206
+
+// ioctl requests on /dev/m3sysctl
+#define M3SC_SET_LED                0x0301
+#define M3SC_GET_LED                0x0302
+#define M3SC_GET_SW                 0x0303
+#define M3SC_CHECK_BAT              0x0304
+#define M3SC_SET_US_LED             0x0305
+#define M3SC_GET_US_LED             0x0306
+
+// LEDs: the upper half of a request selects LEDs, the lower half sets them
+#define LED_RUN_FLG         0x0004
+#define LED_ALM_FLG         0x0002
+#define LED_ERR_FLG         0x0001
+#define LED_US1_FLG         0x0010
+#define LED_US2_FLG         0x0020
+#define LED_US3_FLG         0x0040
+#define M3SC_LED_RUN_ON     ((LED_RUN_FLG << 16) | LED_RUN_FLG)
+#define M3SC_LED_RUN_OFF    (LED_RUN_FLG << 16)
+#define M3SC_LED_ALM_ON     ((LED_ALM_FLG << 16) | LED_ALM_FLG)
+#define M3SC_LED_ALM_OFF    (LED_ALM_FLG << 16)
+#define M3SC_LED_ERR_ON     ((LED_ERR_FLG << 16) | LED_ERR_FLG)
+#define M3SC_LED_ERR_OFF    (LED_ERR_FLG << 16)
+#define M3SC_LED_US1_ON     ((LED_US1_FLG << 16) | LED_US1_FLG)
+#define M3SC_LED_US1_OFF    (LED_US1_FLG << 16)
+#define M3SC_LED_US2_ON     ((LED_US2_FLG << 16) | LED_US2_FLG)
+#define M3SC_LED_US2_OFF    (LED_US2_FLG << 16)
+#define M3SC_LED_US3_ON     ((LED_US3_FLG << 16) | LED_US3_FLG)
+#define M3SC_LED_US3_OFF    (LED_US3_FLG << 16)
+
+// I/O modules
+typedef struct {
+    unsigned short data;
+} M3IO_IN_RELAY;
+
+typedef struct {
+    unsigned short data;
+    unsigned short mask;
+} M3IO_OUT_RELAY;
+
+typedef struct {
+    int unitno;
+    int slotno;
+    int start;
+    int count;
+    union {
+        unsigned char  *pbdata;
+        unsigned short *pwdata;
+        unsigned long  *pldata;
+        M3IO_IN_RELAY  inrly[M3IO_NUM_RELAY_WORD];
+        M3IO_OUT_RELAY outrly[M3IO_NUM_RELAY_WORD];
+        unsigned short wdata[M3IO_NUM_RELAY_WORD];
+    } u;
+} M3IO_ACCESS_REG;
+
+typedef struct {
+    int unitno;
+    int slotno;
+    int position;
+    int data;
+} M3IO_ACCESS_RELAY_POINT;
+
+typedef struct {
+    int cpuno;
+    int start;
+    int count;
+    unsigned short *pdata;
+} M3IO_ACCESS_COM;
+
+typedef struct {
+    int unitno;
+    int slotno;
+    int enable;
+    char name[4];
+    int msize;
+    int num_xreg;
+    int num_yreg;
+    int num_dreg;
+} M3IO_MODULE_INFORMATION;
+
+// Interrupts
+typedef struct {
+    int unitno;
+    int slotno;
+    union {
+        int relayNo;
+    } defData;
+    int msgQId;
+} M3IO_INTER_DEFINE;
+
+typedef struct {
+    int unit;
+    int slot;
+    int channel;
+    int reserved[4];
+} M3IO_MSG_IO;
+
+// Shared devices and link devices
+typedef struct {
+    unsigned short wNumberOfRelay[4];
+    unsigned short wNumberOfRegister[4];
+} M3COMDATACONFIG;
+
+typedef struct {
+    unsigned short wNumberOfRelay[2];
+    unsigned short wNumberOfRegister[2];
+} M3LINKDATACONFIG;
+
+// Commands to sequence CPUs
+typedef struct {
+    unsigned char  formatCode;
+    unsigned char  responseOption;
+    unsigned short srcSlot;
+    unsigned short destSlot;
+    unsigned short mainCode;
+    unsigned short subCode;
+    unsigned short comId;
+    unsigned short dataSize;
+    union {
+        unsigned char  bData[1024];
+        unsigned short wData[512];
+    } dataBuff;
+} MCMD_REQUEST;
+
+typedef struct {
+    unsigned char  formatCode;
+    unsigned char  responseOption;
+    unsigned short srcSlot;
+    unsigned short destSlot;
+    unsigned short mainCode;
+    unsigned short subCode;
+    unsigned short comId;
+    unsigned short errorCode;
+    unsigned short dataSize;
+    union {
+        unsigned char  bData[1024];
+        unsigned short wData[512];
+    } dataBuff;
+} MCMD_RESPONSE;
+
+typedef struct {
+    MCMD_REQUEST  mcmdRequest;
+    MCMD_RESPONSE mcmdResponse;
+    int timeOut;
+} MCMD_STRUCT;
+
+typedef struct {
+    unsigned short accessType;
+    unsigned short devType;
+    long           topDevNo;
+    unsigned short dataNum;
+} M3_READ_SEQDEV;
+
+typedef struct {
+    unsigned short accessType;
+    unsigned short devType;
+    long           topDevNo;
+    unsigned short dataNum;
+    union {
+        unsigned short wData[500];
+    } dataBuff;
+} M3_WRITE_SEQDEV;
+
+#endif // DRVF3RP61SIM_H
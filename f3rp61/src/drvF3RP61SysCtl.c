@@ -68,7 +68,7 @@ static long init(void)
     }
     init_flag = 1;
 
-    f3rp61SysCtl_fd = open("/dev/m3sysctl", O_RDWR);
+    f3rp61SysCtl_fd = f3rp61_backend->open("/dev/m3sysctl", O_RDWR);
     if (f3rp61SysCtl_fd < 0) {
         errlogPrintf("drvF3RP61SysCtl: can't open /dev/m3sysctl [%d] : %s\n", errno, strerror(errno));
         return -1;
@@ -161,7 +161,7 @@ static void setLED(const char led, const int value)
     }
 
     // Issue API function
-    if (ioctl(f3rp61SysCtl_fd, cmd, &data) < 0) {
+    if (f3rp61_backend->ioctl(f3rp61SysCtl_fd, cmd, &data) < 0) {
         errlogPrintf("drvF3RP61SysCtl: ioctl failed [%d] for f3rp61setLED\n", errno);
         return;
     }
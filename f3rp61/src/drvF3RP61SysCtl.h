@@ -7,8 +7,9 @@
 #  include <asm/fam3rtos/fam3rtos_sysctl.h>
 #  include <asm/fam3rtos/m3lib.h>
 #else
-#  error
+#  include <drvF3RP61Sim.h>
 #endif
+#include <drvF3RP61Backend.h>
 
 #if defined(__powerpc__)
 // ioctl
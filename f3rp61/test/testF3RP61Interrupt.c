@@ -0,0 +1,126 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* testF3RP61Interrupt.c - Tests of Interrupts and their Time Stamps
+*
+*      Date: 2026 Oct. 16
+*/
+
+#include <dbAccess.h>
+#include <dbCommon.h>
+#include <dbUnitTest.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <errlog.h>
+#include <iocsh.h>
+#include <testMain.h>
+
+#include <drvF3RP61.h>
+
+void f3rp61Test_registerRecordDeviceDriver(struct dbBase *);
+
+// Time stamp of the record
+static epicsTimeStamp get_time(const char *name)
+{
+    DBADDR addr;
+    if (dbNameToAddr(name, &addr)) {
+        testAbort("no record %s", name);
+    }
+    dbCommon *prec = addr.precord;
+
+    dbScanLock(prec);
+    const epicsTimeStamp time = prec->time;
+    dbScanUnlock(prec);
+
+    return time;
+}
+
+// All the records on the channel are processed upon an interrupt, with
+// the time of the interrupt
+static void testDispatch(void)
+{
+    epicsTimeStamp before, after;
+
+    testDiag("Dispatch of an interrupt");
+
+    iocshCmd("f3rp61SimPut U0,S3,A1 42");
+    iocshCmd("f3rp61SimPut U0,S2,X1 1");
+
+    epicsTimeGetCurrent(&before);
+    iocshCmd("f3rp61SimInterrupt 0 2 1 1 0");
+    epicsThreadSleep(0.2);
+    epicsTimeGetCurrent(&after);
+
+    testdbGetFieldEqual("intr_a1.VAL", DBF_LONG, 42);
+    testdbGetFieldEqual("intr_x1.VAL", DBF_LONG, 1);
+    testdbGetFieldEqual("intr_count.VAL", DBF_LONG, 1);
+
+    const epicsTimeStamp time = get_time("intr_a1");
+    testOk(epicsTimeLessThanEqual(&before, &time) && epicsTimeLessThanEqual(&time, &after),
+           "time stamp taken at the interrupt");
+    const epicsTimeStamp time_x1 = get_time("intr_x1");
+    testOk(epicsTimeEqual(&time, &time_x1), "same time stamp for the records on the channel");
+
+    // Processed without an interrupt, the record keeps the time of the
+    // latest interrupt
+    epicsThreadSleep(0.2);
+    testdbPutFieldOk("intr_a1.PROC", DBF_LONG, 1);
+    const epicsTimeStamp time_proc = get_time("intr_a1");
+    testOk(epicsTimeEqual(&time, &time_proc), "time stamp of the latest interrupt");
+
+    // Records before the first interrupt get the current time
+    epicsTimeGetCurrent(&before);
+    testdbPutFieldOk("intr_none.PROC", DBF_LONG, 1);
+    epicsTimeGetCurrent(&after);
+    const epicsTimeStamp time_none = get_time("intr_none");
+    testOk(epicsTimeLessThanEqual(&before, &time_none) && epicsTimeLessThanEqual(&time_none, &after),
+           "current time before the first interrupt");
+}
+
+// Every interrupt of a burst is received and processes the records,
+// even while they are busy with the previous one
+static void testBurst(void)
+{
+    F3RP61_IO_INTR_STAT before, after;
+
+    testDiag("Burst of interrupts");
+
+    testdbPutFieldOk("intr_count.VAL", DBF_LONG, 0);
+    f3rp61_get_io_interrupt_stat(0, 2, 1, &before);
+
+    iocshCmd("f3rp61SimInterrupt 0 2 1 5 0");
+    epicsThreadSleep(0.5);
+
+    f3rp61_get_io_interrupt_stat(0, 2, 1, &after);
+    testOk(after.received - before.received == 5, "5 interrupts received (%lu)",
+           after.received - before.received);
+    testOk(after.request.count - before.request.count == 5, "5 scan requests (%lu)",
+           after.request.count - before.request.count);
+    testdbGetFieldEqual("intr_count.VAL", DBF_LONG, 5);
+}
+
+MAIN(testF3RP61Interrupt)
+{
+    testPlan(13);
+
+    testdbPrepare();
+    testdbReadDatabase("f3rp61Test.dbd", NULL, NULL);
+    f3rp61Test_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("testF3RP61Interrupt.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testDispatch();
+    testBurst();
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,127 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* testF3RP61OutGroup.c - Tests of Output Groups of Relays
+*
+*      Date: 2026 Oct. 16
+*/
+
+#include <dbAccess.h>
+#include <dbCommon.h>
+#include <dbUnitTest.h>
+#include <epicsStdio.h>
+#include <epicsThread.h>
+#include <errlog.h>
+#include <iocsh.h>
+#include <testMain.h>
+
+void f3rp61Test_registerRecordDeviceDriver(struct dbBase *);
+
+// Whether the record is still waiting for its output group to be flushed
+static int is_active(const char *name)
+{
+    DBADDR addr;
+    if (dbNameToAddr(name, &addr)) {
+        testAbort("no record %s", name);
+    }
+    dbCommon *prec = addr.precord;
+
+    dbScanLock(prec);
+    const int pact = prec->pact;
+    dbScanUnlock(prec);
+
+    return pact;
+}
+
+// Wait until the record completes
+static int wait_processed(const char *name)
+{
+    for (int i = 0; i < 500; i++) {
+        if (!is_active(name)) {
+            return 1;
+        }
+        epicsThreadSleep(0.01);
+    }
+    return 0;
+}
+
+// Read the relay back through the bi record
+static void testRelay(const char *record, int value)
+{
+    char field[64];
+
+    epicsSnprintf(field, sizeof(field), "%s.PROC", record);
+    testdbPutFieldOk(field, DBF_LONG, 1);
+    epicsSnprintf(field, sizeof(field), "%s.VAL", record);
+    testdbGetFieldEqual(field, DBF_LONG, value);
+}
+
+// The relays of the group are written together by the flush record, and
+// only the relays written by the records are changed
+static void testFlush(void)
+{
+    testDiag("Output group with a flush record");
+
+    iocshCmd("f3rp61SimPut U0,S3,Y5 1");
+
+    testdbPutFieldOk("grp_y1.VAL", DBF_LONG, 1);
+    testdbPutFieldOk("grp_y2.VAL", DBF_LONG, 1);
+    testOk(is_active("grp_y1") && is_active("grp_y2"), "records waiting for the flush");
+    testRelay("rb_s3_y1", 0);
+    testRelay("rb_s3_y2", 0);
+
+    testdbPutFieldOk("grp_flush.PROC", DBF_LONG, 1);
+    testOk(wait_processed("grp_y1") && wait_processed("grp_y2"), "records completed by the flush");
+    testRelay("rb_s3_y1", 1);
+    testRelay("rb_s3_y2", 1);
+    testRelay("rb_s3_y5", 1);
+
+    // Relays in another word of the module, in the same flush
+    testdbPutFieldOk("grp_y1.VAL", DBF_LONG, 0);
+    testdbPutFieldOk("grp_y17.VAL", DBF_LONG, 1);
+    testdbPutFieldOk("grp_flush.PROC", DBF_LONG, 1);
+    testOk(wait_processed("grp_y1") && wait_processed("grp_y17"), "records completed by the flush");
+    testRelay("rb_s3_y1", 0);
+    testRelay("rb_s3_y2", 1);
+    testRelay("rb_s3_y5", 1);
+    testRelay("rb_s3_y17", 1);
+}
+
+// Without a flush record, the group is flushed by itself after the first
+// write
+static void testAutoFlush(void)
+{
+    testDiag("Output group without a flush record");
+
+    testdbPutFieldOk("auto_y1.VAL", DBF_LONG, 1);
+    testdbPutFieldOk("auto_y2.VAL", DBF_LONG, 1);
+    testOk(wait_processed("auto_y1") && wait_processed("auto_y2"), "records completed");
+    testRelay("rb_s5_y1", 1);
+    testRelay("rb_s5_y2", 1);
+}
+
+MAIN(testF3RP61OutGroup)
+{
+    testPlan(34);
+
+    testdbPrepare();
+    testdbReadDatabase("f3rp61Test.dbd", NULL, NULL);
+    f3rp61Test_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("testF3RP61OutGroup.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testFlush();
+    testAutoFlush();
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
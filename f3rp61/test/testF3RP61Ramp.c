@@ -0,0 +1,89 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* testF3RP61Ramp.c - Tests of Ramped Writes
+*
+*      Date: 2026 Oct. 16
+*/
+
+#include <dbAccess.h>
+#include <dbUnitTest.h>
+#include <epicsThread.h>
+#include <errlog.h>
+#include <iocsh.h>
+#include <testMain.h>
+
+void f3rp61Test_registerRecordDeviceDriver(struct dbBase *);
+
+// Read the register through the longin record
+static long read_register(void)
+{
+    DBADDR addr;
+    long value = 0;
+
+    testdbPutFieldOk("ramp_a1_rb.PROC", DBF_LONG, 1);
+    if (dbNameToAddr("ramp_a1_rb.VAL", &addr)) {
+        testAbort("no record ramp_a1_rb");
+    }
+    dbGetField(&addr, DBR_LONG, &value, NULL, NULL, NULL);
+
+    return value;
+}
+
+// The first target is written at once, and the following ones are
+// reached at the rate given, by way of the values in between
+static void testRamp(void)
+{
+    testDiag("Ramp to the targets");
+
+    testdbPutFieldOk("ramp_a1.VAL", DBF_LONG, 50);
+    epicsThreadSleep(0.1);
+    testOk1(read_register() == 50);
+
+    // 100 counts in a second
+    testdbPutFieldOk("ramp_a1.VAL", DBF_LONG, 150);
+    epicsThreadSleep(0.4);
+    long value = read_register();
+    testOk(value > 50 && value < 150, "on the way up (%ld)", value);
+    epicsThreadSleep(1.0);
+    testOk1(read_register() == 150);
+
+    // The target changed during the ramp, which goes on from where it is
+    testdbPutFieldOk("ramp_a1.VAL", DBF_LONG, 0);
+    epicsThreadSleep(0.4);
+    value = read_register();
+    testOk(value > 0 && value < 150, "on the way down (%ld)", value);
+    testdbPutFieldOk("ramp_a1.VAL", DBF_LONG, 200);
+    epicsThreadSleep(0.2);
+    const long turned = read_register();
+    testOk(turned > value && turned < 200, "turned back up (%ld)", turned);
+    epicsThreadSleep(2.5);
+    testOk1(read_register() == 200);
+}
+
+MAIN(testF3RP61Ramp)
+{
+    testPlan(16);
+
+    testdbPrepare();
+    testdbReadDatabase("f3rp61Test.dbd", NULL, NULL);
+    f3rp61Test_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("testF3RP61Ramp.db", NULL, NULL);
+
+    iocshCmd("f3rp61RampConfigure 0.005");
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testRamp();
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
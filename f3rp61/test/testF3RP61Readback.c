@@ -0,0 +1,83 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* testF3RP61Readback.c - Tests of Readback of Output Records at iocInit
+*
+*      Date: 2026 Oct. 16
+*/
+
+#include <dbAccess.h>
+#include <dbUnitTest.h>
+#include <errlog.h>
+#include <iocsh.h>
+#include <testMain.h>
+
+void f3rp61Test_registerRecordDeviceDriver(struct dbBase *);
+
+// Devices as left by the sequence CPU, or by the IOC before a restart.
+// The module in U0,S2 has 32 output relays, so that Y33 and above are
+// beyond it.
+static void setDevices(void)
+{
+    iocshCmd("f3rp61SimModule 0 2 YD32 0 2 0");
+    iocshCmd("f3rp61SimPut U0,S2,Y1 1");
+    iocshCmd("f3rp61SimPut U0,S2,Y3 1");
+    iocshCmd("f3rp61SimPut U0,S2,Y20 1");
+    iocshCmd("f3rp61SimPut U0,S2,Y33 1");
+    iocshCmd("f3rp61SimPut U0,S4,A1 1234");
+    iocshCmd("f3rp61SimPut U0,S4,A2 18");
+    iocshCmd("f3rp61SimPut R10 77");
+    iocshCmd("f3rp61SimPut CPU1,D10 4321");
+}
+
+// The relays of the records are read as far as they are on the module,
+// without failing the read of the other relays
+static void testRelays(void)
+{
+    testDiag("Output relays (Y)");
+
+    testdbGetFieldEqual("rb_y1.VAL", DBF_LONG, 5);
+    testdbGetFieldEqual("rb_y1.UDF", DBF_UCHAR, 0);
+    testdbGetFieldEqual("rb_y20.VAL", DBF_LONG, 1);
+    testdbGetFieldEqual("rb_y33.VAL", DBF_LONG, 0);
+    testdbGetFieldEqual("rb_y17_long.VAL", DBF_LONG, 0);
+}
+
+static void testRegisters(void)
+{
+    testDiag("I/O registers (A), shared registers (R) and sequence CPU devices");
+
+    testdbGetFieldEqual("rb_a1.VAL", DBF_LONG, 1234);
+    testdbGetFieldEqual("rb_a2_bcd.VAL", DBF_LONG, 0);
+    testdbGetFieldEqual("rb_r10.VAL", DBF_LONG, 77);
+    testdbGetFieldEqual("rb_seq_d10.VAL", DBF_LONG, 4321);
+}
+
+MAIN(testF3RP61Readback)
+{
+    testPlan(9);
+
+    testdbPrepare();
+    testdbReadDatabase("f3rp61Test.dbd", NULL, NULL);
+    f3rp61Test_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("testF3RP61Readback.db", NULL, NULL);
+
+    iocshCmd("f3rp61ReadbackConfigure 1");
+    setDevices();
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testRelays();
+    testRegisters();
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
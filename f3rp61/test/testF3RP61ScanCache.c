@@ -0,0 +1,90 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* testF3RP61ScanCache.c - Tests of the Scan Cache
+*
+*      Date: 2026 Oct. 16
+*/
+
+#include <dbAccess.h>
+#include <dbUnitTest.h>
+#include <epicsStdio.h>
+#include <epicsThread.h>
+#include <errlog.h>
+#include <iocsh.h>
+#include <testMain.h>
+
+void f3rp61Test_registerRecordDeviceDriver(struct dbBase *);
+
+// Process the record and check the value it has read
+static void testRead(const char *record, int value)
+{
+    char field[64];
+
+    epicsSnprintf(field, sizeof(field), "%s.PROC", record);
+    testdbPutFieldOk(field, DBF_LONG, 1);
+    epicsSnprintf(field, sizeof(field), "%s.VAL", record);
+    testdbGetFieldEqual(field, DBF_LONG, value);
+}
+
+// The first record processed in a pass takes a snapshot, which the
+// others read even if the registers have changed since
+static void testSnapshot(void)
+{
+    testDiag("Records sharing a snapshot");
+
+    iocshCmd("f3rp61SimPut U0,S3,A1 1");
+    iocshCmd("f3rp61SimPut U0,S3,A8 8");
+
+    testRead("cache_a1", 1);
+    iocshCmd("f3rp61SimPut U0,S3,A8 80");
+    testRead("cache_a8", 8);
+    testRead("direct_a8", 80);
+
+    // The next pass takes a new snapshot
+    testRead("cache_a8", 80);
+    testRead("cache_a1", 1);
+}
+
+// Long words come from their own snapshot, the lower word first
+static void testLongWords(void)
+{
+    testDiag("Long words (&L)");
+
+    iocshCmd("f3rp61SimPut U0,S3,A3 0x5678");
+    iocshCmd("f3rp61SimPut U0,S3,A4 0x0001");
+    iocshCmd("f3rp61SimPut U0,S3,A5 5");
+    iocshCmd("f3rp61SimPut U0,S3,A6 0");
+
+    testRead("cache_l3", 0x15678);
+    testRead("cache_l5", 5);
+}
+
+MAIN(testF3RP61ScanCache)
+{
+    testPlan(14);
+
+    testdbPrepare();
+    testdbReadDatabase("f3rp61Test.dbd", NULL, NULL);
+    f3rp61Test_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("testF3RP61ScanCache.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    // Let the first periodic pass go by, the next one being 10 s later
+    epicsThreadSleep(1.0);
+
+    testSnapshot();
+    testLongWords();
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,176 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* testF3RP61Seq.c - Tests of Read Coalescing for Sequence CPUs
+*
+*      Date: 2026 Oct. 16
+*/
+
+#include <dbAccess.h>
+#include <dbCommon.h>
+#include <dbDefs.h>
+#include <dbUnitTest.h>
+#include <epicsStdio.h>
+#include <epicsThread.h>
+#include <errlog.h>
+#include <iocsh.h>
+#include <testMain.h>
+
+#include <drvF3RP61Seq.h>
+
+void f3rp61Test_registerRecordDeviceDriver(struct dbBase *);
+
+static const char *records[] = {
+    "seq_d100", "seq_d101", "seq_d102", "seq_d103", "seq_d100_dup",
+};
+static const char *gap_records[] = {
+    "seq_d300", "seq_d310",
+};
+static const char *error_records[] = {
+    "seq_d65536", "seq_d65537",
+};
+
+// Wait until the asynchronous processing of the record completes
+static int wait_processed(const char *name)
+{
+    DBADDR addr;
+    if (dbNameToAddr(name, &addr)) {
+        testAbort("no record %s", name);
+    }
+    dbCommon *prec = addr.precord;
+
+    for (int i = 0; i < 500; i++) {
+        dbScanLock(prec);
+        const int pact = prec->pact;
+        dbScanUnlock(prec);
+        if (!pact) {
+            return 1;
+        }
+        epicsThreadSleep(0.01);
+    }
+    return 0;
+}
+
+// Process the records while the sequence CPU is busy with the blocker,
+// so that their requests are queued together, and wait for them all
+static void process_queued(const char **names, int count)
+{
+    iocshCmd("f3rp61SimDelay 0 50000");
+
+    testdbPutFieldOk("seq_blocker.PROC", DBF_LONG, 1);
+    epicsThreadSleep(0.01);
+    for (int i = 0; i < count; i++) {
+        char field[64];
+        epicsSnprintf(field, sizeof(field), "%s.PROC", names[i]);
+        testdbPutFieldOk(field, DBF_LONG, 1);
+    }
+
+    testOk(wait_processed("seq_blocker"), "seq_blocker completed");
+    for (int i = 0; i < count; i++) {
+        testOk(wait_processed(names[i]), "%s completed", names[i]);
+    }
+
+    iocshCmd("f3rp61SimDelay 0 0");
+}
+
+// Requests queued while the sequence CPU is busy are served by a single
+// command, and every record completes with its own device
+static void testCoalesce(void)
+{
+    F3RP61_SEQ_STAT before, after;
+
+    testDiag("Reads of adjacent and identical devices");
+
+    iocshCmd("f3rp61SimPut CPU1,D100 100");
+    iocshCmd("f3rp61SimPut CPU1,D101 101");
+    iocshCmd("f3rp61SimPut CPU1,D102 102");
+    iocshCmd("f3rp61SimPut CPU1,D103 103");
+    iocshCmd("f3rp61SimPut CPU1,D200 200");
+
+    f3rp61Seq_getStat(1, &before);
+    process_queued(records, NELEMENTS(records));
+    f3rp61Seq_getStat(1, &after);
+    testOk(after.commands - before.commands == 2, "2 commands issued (%lu)",
+           after.commands - before.commands);
+    testOk(after.requests - before.requests == 6, "6 requests completed (%lu)",
+           after.requests - before.requests);
+    testOk(after.queued == 0, "no request left in the queue (%d)", after.queued);
+
+    testdbGetFieldEqual("seq_blocker.VAL", DBF_LONG, 200);
+    testdbGetFieldEqual("seq_d100.VAL", DBF_LONG, 100);
+    testdbGetFieldEqual("seq_d101.VAL", DBF_LONG, 101);
+    testdbGetFieldEqual("seq_d102.VAL", DBF_LONG, 102);
+    testdbGetFieldEqual("seq_d103.VAL", DBF_LONG, 103);
+    testdbGetFieldEqual("seq_d100_dup.VAL", DBF_LONG, 100);
+}
+
+// Devices apart from each other are not merged, so that the devices in
+// between are never read
+static void testGap(void)
+{
+    F3RP61_SEQ_STAT before, after;
+
+    testDiag("Reads of devices apart");
+
+    iocshCmd("f3rp61SimPut CPU1,D300 300");
+    iocshCmd("f3rp61SimPut CPU1,D310 310");
+
+    f3rp61Seq_getStat(1, &before);
+    process_queued(gap_records, NELEMENTS(gap_records));
+    f3rp61Seq_getStat(1, &after);
+
+    testOk(after.commands - before.commands == 3, "3 commands issued (%lu)",
+           after.commands - before.commands);
+    testdbGetFieldEqual("seq_d300.VAL", DBF_LONG, 300);
+    testdbGetFieldEqual("seq_d310.VAL", DBF_LONG, 310);
+}
+
+// A merged read failing on a device is issued again request by request,
+// and only the record of the device fails
+static void testMergedError(void)
+{
+    F3RP61_SEQ_STAT before, after;
+
+    testDiag("Merged read failing on one of the devices");
+
+    iocshCmd("f3rp61SimPut CPU1,D65536 7");
+
+    f3rp61Seq_getStat(1, &before);
+    process_queued(error_records, NELEMENTS(error_records));
+    f3rp61Seq_getStat(1, &after);
+
+    testOk(after.commands - before.commands == 4, "4 commands issued (%lu)",
+           after.commands - before.commands);
+    testOk(after.errors - before.errors == 2, "merged command and D65537 failed (%lu)",
+           after.errors - before.errors);
+    testdbGetFieldEqual("seq_d65536.VAL", DBF_LONG, 7);
+    testdbGetFieldEqual("seq_d65536.UDF", DBF_UCHAR, 0);
+    testdbGetFieldEqual("seq_d65537.UDF", DBF_UCHAR, 1);
+}
+
+MAIN(testF3RP61Seq)
+{
+    testPlan(41);
+
+    testdbPrepare();
+    testdbReadDatabase("f3rp61Test.dbd", NULL, NULL);
+    f3rp61Test_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("testF3RP61Seq.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testCoalesce();
+    testGap();
+    testMergedError();
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,108 @@
+/*************************************************************************
+* Copyright (c) 2026 High Energy Accelerator Research Organization (KEK)
+*
+* F3RP61 Device Support 2.0.0
+* and higher are distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+**************************************************************************
+* testF3RP61Write.c - Tests of Write Suppression and Staged Registers
+*
+*      Date: 2026 Oct. 16
+*/
+
+#include <dbAccess.h>
+#include <dbUnitTest.h>
+#include <epicsStdio.h>
+#include <epicsThread.h>
+#include <errlog.h>
+#include <iocsh.h>
+#include <testMain.h>
+
+void f3rp61Test_registerRecordDeviceDriver(struct dbBase *);
+
+// Read the register back through the input record
+static void testRegister(const char *record, int value)
+{
+    char field[64];
+
+    epicsSnprintf(field, sizeof(field), "%s.PROC", record);
+    testdbPutFieldOk(field, DBF_LONG, 1);
+    epicsSnprintf(field, sizeof(field), "%s.VAL", record);
+    testdbGetFieldEqual(field, DBF_LONG, value);
+}
+
+// The value last written is skipped, unless it has been written longer
+// ago than the refresh interval of 1 second
+static void testSuppress(void)
+{
+    testDiag("Write suppression (&S)");
+
+    testdbPutFieldOk("write_suppress.VAL", DBF_LONG, 5);
+    testRegister("write_suppress_rb", 5);
+
+    // The register overwritten behind the record is not written again
+    iocshCmd("f3rp61SimPut U0,S4,A1 0");
+    testdbPutFieldOk("write_suppress.VAL", DBF_LONG, 5);
+    testRegister("write_suppress_rb", 0);
+
+    testdbPutFieldOk("write_suppress.VAL", DBF_LONG, 6);
+    testRegister("write_suppress_rb", 6);
+
+    // Until the refresh interval has passed
+    iocshCmd("f3rp61SimPut U0,S4,A1 0");
+    epicsThreadSleep(1.5);
+    testdbPutFieldOk("write_suppress.VAL", DBF_LONG, 6);
+    testRegister("write_suppress_rb", 6);
+}
+
+// The staged registers are written only by the commit record, and only
+// once
+static void testStage(void)
+{
+    testDiag("Staged registers (&T)");
+
+    testdbPutFieldOk("stage_long.VAL", DBF_LONG, 70000);
+    testdbPutFieldOk("stage_word.VAL", DBF_LONG, 3);
+    testRegister("stage_long_rb", 0);
+    testRegister("stage_word_rb", 0);
+
+    testdbPutFieldOk("stage_commit.PROC", DBF_LONG, 1);
+    testRegister("stage_long_rb", 70000);
+    testRegister("stage_word_rb", 3);
+
+    // Nothing staged since the last commit
+    iocshCmd("f3rp61SimPut U0,S4,A13 0");
+    testdbPutFieldOk("stage_commit.PROC", DBF_LONG, 1);
+    testRegister("stage_word_rb", 0);
+
+    // Only the register staged is written
+    iocshCmd("f3rp61SimPut U0,S4,A11 0");
+    testdbPutFieldOk("stage_word.VAL", DBF_LONG, 4);
+    testdbPutFieldOk("stage_commit.PROC", DBF_LONG, 1);
+    testRegister("stage_word_rb", 4);
+    testRegister("stage_long_rb", 0);
+}
+
+MAIN(testF3RP61Write)
+{
+    testPlan(32);
+
+    testdbPrepare();
+    testdbReadDatabase("f3rp61Test.dbd", NULL, NULL);
+    f3rp61Test_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("testF3RP61Write.db", NULL, NULL);
+
+    iocshCmd("f3rp61WriteSuppressConfigure 1");
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testSuppress();
+    testStage();
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}